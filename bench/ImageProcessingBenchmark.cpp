@@ -0,0 +1,140 @@
+/**
+ * @file   bench/ImageProcessingBenchmark.cpp
+ * @brief  Micro-benchmarks of the image processing kernels.
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+
+#include "ImageProcessingLib/euclidean_distance.h"
+#include "ImageProcessingLib/flip.h"
+#include "ImageProcessingLib/resize.h"
+#include "ImageProcessingLib/rotate.h"
+#include "ImageProcessingLib/rotate_90_degrees.h"
+#include "ImageProcessingLib/rotate_and_crop.h"
+#include "UtilitiesLib/Filler.h"
+#include "UtilitiesLib/Interpolation.h"
+
+using namespace pink;
+
+namespace {
+
+/// Neuron dimension of a rotated image, which fits into the image
+int get_cropped_dim(int image_dim)
+{
+    return image_dim / std::sqrt(2.0);
+}
+
+std::vector<float> get_image(int image_dim)
+{
+    std::vector<float> image(image_dim * image_dim);
+    fill_random_uniform(&image[0], image.size(), 1);
+    return image;
+}
+
+/// Counts the processed images and the bytes of the source images
+void set_processed(benchmark::State& state, int image_dim)
+{
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * image_dim * image_dim * sizeof(float));
+    state.counters["image_dim"] = image_dim;
+}
+
+} // namespace
+
+static void BM_rotate_bilinear(benchmark::State& state)
+{
+    int image_dim = state.range(0);
+    auto&& src = get_image(image_dim);
+    std::vector<float> dst(image_dim * image_dim);
+
+    for (auto _ : state) {
+        rotate_bilinear(&src[0], &dst[0], image_dim, image_dim, image_dim, image_dim, 0.3f);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed(state, image_dim);
+}
+BENCHMARK(BM_rotate_bilinear)->RangeMultiplier(2)->Range(64, 256);
+
+static void BM_rotate_and_crop(benchmark::State& state)
+{
+    int image_dim = state.range(0);
+    int neuron_dim = get_cropped_dim(image_dim);
+    auto&& src = get_image(image_dim);
+    std::vector<float> dst(neuron_dim * neuron_dim);
+    auto interpolation = static_cast<Interpolation>(state.range(1));
+
+    for (auto _ : state) {
+        rotate_and_crop(&src[0], &dst[0], image_dim, image_dim, neuron_dim, neuron_dim, 0.3f, interpolation);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed(state, image_dim);
+}
+BENCHMARK(BM_rotate_and_crop)->ArgsProduct({{64, 128, 256},
+    {static_cast<int>(Interpolation::NEAREST_NEIGHBOR), static_cast<int>(Interpolation::BILINEAR)}});
+
+static void BM_rotate_90_degrees(benchmark::State& state)
+{
+    int image_dim = state.range(0);
+    auto&& src = get_image(image_dim);
+    std::vector<float> dst(image_dim * image_dim);
+
+    for (auto _ : state) {
+        rotate_90_degrees(&src[0], &dst[0], image_dim, image_dim);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed(state, image_dim);
+}
+BENCHMARK(BM_rotate_90_degrees)->RangeMultiplier(2)->Range(64, 256);
+
+static void BM_flip(benchmark::State& state)
+{
+    int image_dim = state.range(0);
+    auto&& src = get_image(image_dim);
+    std::vector<float> dst(image_dim * image_dim);
+
+    for (auto _ : state) {
+        flip(&src[0], &dst[0], image_dim, image_dim);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed(state, image_dim);
+}
+BENCHMARK(BM_flip)->RangeMultiplier(2)->Range(64, 256);
+
+static void BM_resize(benchmark::State& state)
+{
+    int image_dim = state.range(0);
+    int neuron_dim = get_cropped_dim(image_dim);
+    auto&& src = get_image(image_dim);
+    std::vector<float> dst(neuron_dim * neuron_dim);
+
+    for (auto _ : state) {
+        resize(&src[0], &dst[0], image_dim, image_dim, neuron_dim, neuron_dim);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed(state, image_dim);
+}
+BENCHMARK(BM_resize)->RangeMultiplier(2)->Range(64, 256);
+
+static void BM_euclidean_distance_square_offset(benchmark::State& state)
+{
+    int image_dim = state.range(0);
+    int euclidean_distance_dim = get_cropped_dim(image_dim);
+    auto&& a = get_image(image_dim);
+    std::vector<float> b(image_dim * image_dim);
+    fill_random_uniform(&b[0], b.size(), 2);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(euclidean_distance_square_offset(&a[0], &b[0], image_dim, euclidean_distance_dim));
+    }
+    set_processed(state, image_dim);
+}
+BENCHMARK(BM_euclidean_distance_square_offset)->RangeMultiplier(2)->Range(64, 256);
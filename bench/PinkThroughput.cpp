@@ -0,0 +1,557 @@
+/**
+ * @file   bench/PinkThroughput.cpp
+ * @brief  End-to-end throughput of the training and mapping with synthetic data.
+ *
+ * A data file of random images is generated in the binary format of FILE_FORMATS.md.
+ * The training and mapping run through main_generic with the input data of the Pink
+ * options given after "--", so that all execution paths (batches, prefetching, Hogwild,
+ * backends, coarse-to-fine search) and the writing of the results are measured.
+ * After the warm-up runs, each repetition is a complete run of Pink. The throughput is
+ * given for each repetition and the latency for each image, which is the time between
+ * the reading of consecutive images. Batches are read at once, so that the latency is
+ * concentrated on the last image of each batch. The peak resident set size is the maximum of the
+ * process so far, therefore the modes should be measured separately for accurate values.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <omp.h>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Pink/main_generic.h"
+#include "SelfOrganizingMapLib/CartesianLayout.h"
+#include "SelfOrganizingMapLib/HexagonalLayout.h"
+#include "UtilitiesLib/FileDataType.h"
+#include "UtilitiesLib/Filler.h"
+#include "UtilitiesLib/InputData.h"
+#include "UtilitiesLib/Layout.h"
+#include "UtilitiesLib/pink_exception.h"
+
+using myclock = std::chrono::steady_clock;
+using namespace pink;
+
+namespace {
+
+struct Options
+{
+    bool train = true;
+    bool map = true;
+    uint32_t number_of_images = 1000;
+    uint32_t image_dim = 64;
+    uint32_t number_of_channels = 1;
+    FileDataType data_type = FileDataType::FLOAT32;
+    std::string data_filename = "pink_throughput_data.bin";
+    std::string som_filename;
+    std::string result_filename;
+    bool generate_only = false;
+    bool keep_data_file = false;
+    uint32_t number_of_warm_up_runs = 1;
+    uint32_t number_of_repetitions = 5;
+    uint32_t seed = 1234;
+    std::string json_filename;
+    std::vector<std::string> pink_arguments;
+};
+
+struct Statistics
+{
+    std::string mode;
+    InputData input_data;
+    std::vector<double> throughputs;
+    std::vector<double> latencies;
+    long peak_rss_kilobytes = 0;
+};
+
+void print_usage()
+{
+    std::cout << "\n"
+                 "  USAGE: PinkThroughput [Options] [-- Pink options]\n"
+                 "\n"
+                 "  Generates a data file of random images and measures the throughput of the training\n"
+                 "  and mapping with Pink on the CPU. All options after -- are passed to Pink (see Pink --help),\n"
+                 "  e.g. --som-width, --numrot, --batch-size, --prefetch, or --euclidean-distance-backend.\n"
+                 "  The random initial SOM of the training and mapping and the results are written next to the data file.\n"
+                 "  Use OMP_NUM_THREADS or --numthreads to set the number of threads.\n"
+                 "\n"
+                 "  Options:\n"
+                 "\n"
+                 "    --mode <string>                      Measured execution paths: train, map, or both (default).\n"
+                 "    --number-of-images <int>             Number of images in the data file (default = 1000).\n"
+                 "    --image-dimension <int>              Width and height of the images (default = 64).\n"
+                 "    --channels <int>                     Number of channels of the images (default = 1).\n"
+                 "                                         Only single-channel images can be trained and mapped.\n"
+                 "    --data-type <string>                 Data type of the data file: float32 (default), uint8, or uint16.\n"
+                 "    --data-file <string>                 Name of the data file (default = pink_throughput_data.bin).\n"
+                 "    --generate-only                      Generate the data file and exit.\n"
+                 "    --keep-data-file                     Do not remove the data, SOM, and result files at the end.\n"
+                 "    --warm-up <int>                      Number of runs before the measurement (default = 1).\n"
+                 "    --repetitions <int>                  Number of measured runs (default = 5).\n"
+                 "    --seed, -s <int>                     Seed for the random images, the SOM, and Pink (default = 1234).\n"
+                 "    --json <string>                      Write the statistics as single-line JSON objects to the file.\n"
+                 "    --help, -h                           Print this lines.\n"
+              << std::endl;
+}
+
+Options parse_options(int argc, char **argv)
+{
+    Options options;
+
+    // All arguments after -- are passed to Pink
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--") {
+            options.pink_arguments.assign(argv + i + 1, argv + argc);
+            argc = i;
+            break;
+        }
+    }
+
+    static struct option long_options[] = {
+        {"mode",                         1, 0, 0},
+        {"number-of-images",             1, 0, 1},
+        {"image-dimension",              1, 0, 2},
+        {"channels",                     1, 0, 3},
+        {"data-type",                    1, 0, 4},
+        {"data-file",                    1, 0, 5},
+        {"generate-only",                0, 0, 6},
+        {"keep-data-file",               0, 0, 7},
+        {"warm-up",                      1, 0, 10},
+        {"repetitions",                  1, 0, 11},
+        {"seed",                         1, 0, 's'},
+        {"json",                         1, 0, 12},
+        {"help",                         0, 0, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int c = 0;
+    int option_index = 0;
+    while ((c = getopt_long(argc, argv, "s:h", long_options, &option_index)) != -1)
+    {
+        switch (c)
+        {
+            case 0:
+            {
+                std::string mode(optarg);
+                if (mode != "train" and mode != "map" and mode != "both")
+                    throw pink::exception("Unknown mode " + mode + ", must be train, map, or both.");
+                options.train = mode != "map";
+                options.map = mode != "train";
+                break;
+            }
+            case 1:
+                options.number_of_images = std::stoul(optarg);
+                if (options.number_of_images == 0) throw pink::exception("number-of-images must be positive.");
+                break;
+            case 2:
+                options.image_dim = std::stoul(optarg);
+                if (options.image_dim == 0) throw pink::exception("image-dimension must be positive.");
+                break;
+            case 3:
+                options.number_of_channels = std::stoul(optarg);
+                if (options.number_of_channels == 0) throw pink::exception("channels must be positive.");
+                break;
+            case 4:
+            {
+                std::string data_type(optarg);
+                if (data_type == "float32") options.data_type = FileDataType::FLOAT32;
+                else if (data_type == "uint8") options.data_type = FileDataType::UINT8;
+                else if (data_type == "uint16") options.data_type = FileDataType::UINT16;
+                else throw pink::exception("Unknown data-type " + data_type + ", must be float32, uint8, or uint16.");
+                break;
+            }
+            case 5:
+                options.data_filename = optarg;
+                break;
+            case 6:
+                options.generate_only = true;
+                options.keep_data_file = true;
+                break;
+            case 7:
+                options.keep_data_file = true;
+                break;
+            case 10:
+                options.number_of_warm_up_runs = std::stoul(optarg);
+                break;
+            case 11:
+                options.number_of_repetitions = std::stoul(optarg);
+                if (options.number_of_repetitions == 0) throw pink::exception("repetitions must be positive.");
+                break;
+            case 's':
+                options.seed = std::stoul(optarg);
+                break;
+            case 12:
+                options.json_filename = optarg;
+                break;
+            case 'h':
+                print_usage();
+                exit(0);
+            case '?':
+                print_usage();
+                throw pink::exception("Unknown option");
+            default:
+                throw pink::exception("Unhandled option");
+        }
+    }
+
+    if (optind < argc) {
+        print_usage();
+        throw pink::exception("Unknown argument " + std::string(argv[optind]));
+    }
+
+    if (options.number_of_channels != 1 and !options.generate_only)
+        throw pink::exception("Only single-channel images can be trained and mapped, use --generate-only.");
+
+    std::string basename = options.data_filename.substr(0, options.data_filename.find_last_of("."));
+    options.som_filename = basename + "_som.bin";
+    options.result_filename = basename + "_result.bin";
+
+    return options;
+}
+
+/// Writes a data file with random values, which are uniformly distributed in [0, 1] for
+/// floating point numbers or cover the full range of the integer types
+///
+/// <file format version> 0 <data-type> <number of entries> <data layout> <data>
+void generate_data_file(Options const& options)
+{
+    std::ofstream os(options.data_filename, std::ios::binary);
+    if (!os) throw pink::exception("Error opening " + options.data_filename);
+
+    std::vector<int> header{2, 0, static_cast<int>(options.data_type), static_cast<int>(options.number_of_images), 0};
+    if (options.number_of_channels == 1) {
+        header.insert(header.end(), {2, static_cast<int>(options.image_dim), static_cast<int>(options.image_dim)});
+    } else {
+        header.insert(header.end(), {3, static_cast<int>(options.number_of_channels),
+            static_cast<int>(options.image_dim), static_cast<int>(options.image_dim)});
+    }
+    os.write(reinterpret_cast<char const*>(header.data()), header.size() * sizeof(int));
+
+    std::mt19937 engine(options.seed);
+    size_t image_size = options.number_of_channels * options.image_dim * options.image_dim;
+    std::vector<char> image(image_size * get_size(options.data_type));
+
+    for (uint32_t i = 0; i != options.number_of_images; ++i) {
+        if (options.data_type == FileDataType::UINT8) {
+            std::uniform_int_distribution<int> distribution(0, 255);
+            for (size_t j = 0; j != image_size; ++j) image[j] = static_cast<char>(distribution(engine));
+        } else if (options.data_type == FileDataType::UINT16) {
+            std::uniform_int_distribution<int> distribution(0, 65535);
+            auto *p = reinterpret_cast<uint16_t*>(image.data());
+            for (size_t j = 0; j != image_size; ++j) p[j] = distribution(engine);
+        } else {
+            std::uniform_real_distribution<float> distribution(0.0, 1.0);
+            auto *p = reinterpret_cast<float*>(image.data());
+            for (size_t j = 0; j != image_size; ++j) p[j] = distribution(engine);
+        }
+        os.write(image.data(), image.size());
+    }
+
+    if (!os) throw pink::exception("Error writing " + options.data_filename);
+}
+
+/// Value of the nearest rank, the values must be sorted
+double get_percentile(std::vector<double> const& values, double percentile)
+{
+    size_t rank = std::ceil(percentile / 100.0 * values.size());
+    return values[std::max(rank, static_cast<size_t>(1)) - 1];
+}
+
+long get_peak_rss_kilobytes()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/// Forwards to the data iterator of Pink and records the time between consecutive increments,
+/// which is the processing time of an image including the reading of the next one
+template <typename Iterator>
+class LatencyIterator
+{
+public:
+
+    LatencyIterator(Iterator& iterator, std::vector<double>& latencies)
+     : iterator(iterator),
+       latencies(latencies),
+       last_time(myclock::now())
+    {}
+
+    bool operator != (LatencyIterator const& other) const
+    {
+        return iterator != other.iterator;
+    }
+
+    LatencyIterator& operator ++ ()
+    {
+        ++iterator;
+        auto&& time = myclock::now();
+        latencies.push_back(std::chrono::duration<double>(time - last_time).count());
+        last_time = time;
+        return *this;
+    }
+
+    decltype(auto) operator * () const
+    {
+        return *iterator;
+    }
+
+    void set_to_position(uint32_t position)
+    {
+        iterator.set_to_position(position);
+        last_time = myclock::now();
+    }
+
+    int get_number_of_entries() const
+    {
+        return iterator.get_number_of_entries();
+    }
+
+private:
+
+    Iterator& iterator;
+    std::vector<double>& latencies;
+    myclock::time_point last_time;
+};
+
+template <typename T>
+struct TypeTag
+{
+    typedef T type;
+};
+
+/// Calls the function with the tag of the SOM layout of the input data, like main_cpu
+template <typename Function>
+auto call_with_som_layout(InputData const& input_data, Function&& function)
+{
+    if (input_data.layout == Layout::HEXAGONAL) return function(TypeTag<HexagonalLayout>());
+    if (input_data.dimensionality == 1) return function(TypeTag<CartesianLayout<1>>());
+    if (input_data.dimensionality == 2) return function(TypeTag<CartesianLayout<2>>());
+    if (input_data.dimensionality == 3) return function(TypeTag<CartesianLayout<3>>());
+    throw pink::exception("Unsupported dimensionality of " + std::to_string(input_data.dimensionality));
+}
+
+/// Returns the input data of Pink for the execution path. The Pink options of the command line
+/// follow the defaults of the benchmark and take precedence over them.
+InputData get_input_data(Options const& options, ExecutionPath execution_path)
+{
+    std::vector<std::string> arguments{"Pink", "--cuda-off", "--seed", std::to_string(options.seed),
+        "--init", options.som_filename};
+    arguments.insert(arguments.end(), options.pink_arguments.begin(), options.pink_arguments.end());
+    if (execution_path == ExecutionPath::TRAIN) {
+        arguments.insert(arguments.end(), {"--train", options.data_filename, options.result_filename});
+    } else {
+        arguments.insert(arguments.end(), {"--map", options.data_filename, options.result_filename, options.som_filename});
+    }
+
+    std::vector<char*> argv;
+    for (auto&& argument : arguments) argv.push_back(&argument[0]);
+
+    // Restart the option parsing of getopt_long
+    optind = 0;
+    return InputData(argv.size(), argv.data());
+}
+
+/// Writes the SOM with uniform random values in [0, 1], which is trained and mapped
+void write_initial_som(Options const& options, InputData const& input_data)
+{
+    // The SOM file does not exist yet
+    InputData som_input_data = input_data;
+    som_input_data.init = SOMInitialization::ZERO;
+
+    call_with_som_layout(som_input_data, [&](auto tag) {
+        typedef typename decltype(tag)::type SOMLayout;
+        SOM<SOMLayout, CartesianLayout<2>, float> som(som_input_data);
+        fill_random_uniform(som.get_data_pointer(), som.get_number_of_neurons() * som.get_neuron_size(), options.seed);
+        write(som, options.som_filename);
+    });
+}
+
+/// Complete run of Pink as main_generic(input_data) and returns the latencies in seconds
+std::vector<double> run_pink(InputData const& input_data)
+{
+    return call_with_som_layout(input_data, [&](auto tag) {
+        typedef typename decltype(tag)::type SOMLayout;
+        typedef CartesianLayout<2> DataLayout;
+
+        std::vector<double> latencies;
+        latencies.reserve(static_cast<size_t>(input_data.number_of_data_entries) * input_data.numIter);
+
+        set_use_huge_pages(input_data.use_huge_pages);
+        SOM<SOMLayout, DataLayout, float> som(input_data);
+
+        auto&& run = [&](auto& iter_data_cur, auto& iter_data_end) {
+            typedef LatencyIterator<typename std::decay<decltype(iter_data_cur)>::type> IteratorType;
+            IteratorType latency_iter_data_cur(iter_data_cur, latencies);
+            IteratorType latency_iter_data_end(iter_data_end, latencies);
+            main_generic<SOMLayout, DataLayout, float, false>(input_data, som, latency_iter_data_cur, latency_iter_data_end);
+        };
+
+        if (input_data.use_mmap and MmapDataIterator<DataLayout, float>::is_applicable(input_data.data_filename)) {
+            auto&& iter_data_cur = MmapDataIterator<DataLayout, float>(input_data.data_filename, input_data.seed,
+                input_data.shuffle_block_size, input_data.shuffle_buffer_size);
+            auto&& iter_data_end = MmapDataIterator<DataLayout, float>(input_data.data_filename, true);
+            run(iter_data_cur, iter_data_end);
+        } else {
+            std::ifstream ifs(input_data.data_filename);
+            if (!ifs) throw pink::exception("Error opening " + input_data.data_filename);
+            auto&& iter_data_cur = DataIterator<DataLayout, float>(ifs, input_data.seed,
+                input_data.shuffle_block_size, input_data.shuffle_buffer_size);
+            auto&& iter_data_end = DataIterator<DataLayout, float>(ifs, true);
+            run(iter_data_cur, iter_data_end);
+        }
+
+        return latencies;
+    });
+}
+
+/// Warm-up and measured runs of Pink with the input data
+Statistics measure(Options const& options, std::string const& mode, InputData const& input_data)
+{
+    Statistics statistics;
+    statistics.mode = mode;
+    statistics.input_data = input_data;
+
+    for (uint32_t i = 0; i != options.number_of_warm_up_runs; ++i) run_pink(input_data);
+
+    for (uint32_t i = 0; i != options.number_of_repetitions; ++i) {
+        auto&& start_time = myclock::now();
+        auto&& latencies = run_pink(input_data);
+        double duration = std::chrono::duration<double>(myclock::now() - start_time).count();
+        statistics.throughputs.push_back(latencies.size() / duration);
+        statistics.latencies.insert(statistics.latencies.end(), latencies.begin(), latencies.end());
+    }
+
+    std::sort(statistics.latencies.begin(), statistics.latencies.end());
+    statistics.peak_rss_kilobytes = get_peak_rss_kilobytes();
+    return statistics;
+}
+
+double get_mean(std::vector<double> const& values)
+{
+    return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+}
+
+double get_standard_deviation(std::vector<double> const& values)
+{
+    double mean = get_mean(values);
+    double sum = 0.0;
+    for (auto&& value : values) sum += (value - mean) * (value - mean);
+    return values.size() > 1 ? std::sqrt(sum / (values.size() - 1)) : 0.0;
+}
+
+void print(Statistics const& statistics)
+{
+    auto&& throughputs = statistics.throughputs;
+    auto&& latencies = statistics.latencies;
+
+    std::cout << "\n  Mode = " << statistics.mode << "\n"
+              << std::fixed << std::setprecision(2)
+              << "  Throughput (images/s) = " << get_mean(throughputs) << " +- " << get_standard_deviation(throughputs)
+              << "  (min " << *std::min_element(throughputs.begin(), throughputs.end())
+              << ", max " << *std::max_element(throughputs.begin(), throughputs.end()) << ")\n"
+              << std::setprecision(3)
+              << "  Latency (ms) = p50 " << get_percentile(latencies, 50) * 1e3
+              << ", p90 " << get_percentile(latencies, 90) * 1e3
+              << ", p99 " << get_percentile(latencies, 99) * 1e3
+              << ", max " << latencies.back() * 1e3 << "\n"
+              << "  Peak RSS (MB) = " << statistics.peak_rss_kilobytes / 1024.0 << "\n"
+              << std::defaultfloat << std::flush;
+}
+
+void write_json(std::ostream& os, Options const& options, Statistics const& statistics)
+{
+    auto&& throughputs = statistics.throughputs;
+    auto&& latencies = statistics.latencies;
+    auto&& input_data = statistics.input_data;
+
+    os << "{\"mode\": \"" << statistics.mode << "\""
+       << ", \"number_of_images\": " << options.number_of_images
+       << ", \"image_dimension\": " << options.image_dim
+       << ", \"data_type\": \"" << options.data_type << "\""
+       << ", \"layout\": \"" << input_data.layout << "\""
+       << ", \"som_width\": " << input_data.som_width
+       << ", \"som_height\": " << input_data.som_height
+       << ", \"neuron_dimension\": " << input_data.neuron_dim
+       << ", \"euclidean_distance_dimension\": " << input_data.euclidean_distance_dim
+       << ", \"number_of_rotations\": " << input_data.number_of_rotations
+       << ", \"use_flip\": " << (input_data.use_flip ? "true" : "false")
+       << ", \"number_of_iterations\": " << input_data.numIter
+       << ", \"batch_size\": " << input_data.batch_size
+       << ", \"prefetch_size\": " << input_data.prefetch_size
+       << ", \"hogwild\": " << (input_data.hogwild ? "true" : "false")
+       << ", \"euclidean_distance_backend\": \"" << input_data.euclidean_distance_backend << "\""
+       << ", \"coarse_rotation_step\": " << input_data.coarse_rotation_step
+       << ", \"threads\": " << omp_get_max_threads()
+       << ", \"repetitions\": " << options.number_of_repetitions
+       << ", \"images_per_second\": {\"mean\": " << get_mean(throughputs)
+       << ", \"stddev\": " << get_standard_deviation(throughputs)
+       << ", \"min\": " << *std::min_element(throughputs.begin(), throughputs.end())
+       << ", \"max\": " << *std::max_element(throughputs.begin(), throughputs.end()) << "}"
+       << ", \"latency_seconds\": {\"p50\": " << get_percentile(latencies, 50)
+       << ", \"p90\": " << get_percentile(latencies, 90)
+       << ", \"p99\": " << get_percentile(latencies, 99)
+       << ", \"max\": " << latencies.back() << "}"
+       << ", \"peak_rss_bytes\": " << statistics.peak_rss_kilobytes * 1024 << "}" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    try {
+        auto&& options = parse_options(argc, argv);
+
+        std::cout << "\n  Generate " << options.number_of_images << " images of " << options.number_of_channels
+                  << " x " << options.image_dim << " x " << options.image_dim << " " << options.data_type
+                  << " in " << options.data_filename << std::endl;
+        generate_data_file(options);
+        if (options.generate_only) return 0;
+
+        std::vector<std::pair<std::string, InputData>> modes;
+        if (options.train) modes.emplace_back("train", get_input_data(options, ExecutionPath::TRAIN));
+        if (options.map) modes.emplace_back("map", get_input_data(options, ExecutionPath::MAP));
+
+        write_initial_som(options, modes.front().second);
+
+        std::cout << "  Threads = " << omp_get_max_threads() << ", warm-up runs = " << options.number_of_warm_up_runs
+                  << ", repetitions = " << options.number_of_repetitions << std::endl;
+
+        std::vector<Statistics> result;
+        for (auto&& mode : modes) result.push_back(measure(options, mode.first, mode.second));
+
+        for (auto&& statistics : result) print(statistics);
+
+        if (!options.json_filename.empty()) {
+            std::ofstream os(options.json_filename);
+            if (!os) throw pink::exception("Error opening " + options.json_filename);
+            for (auto&& statistics : result) write_json(os, options, statistics);
+        }
+
+        if (!options.keep_data_file) {
+            std::remove(options.data_filename.c_str());
+            std::remove(options.som_filename.c_str());
+            std::remove(options.result_filename.c_str());
+        }
+
+    } catch ( std::exception const& e ) {
+        std::cout << "PinkThroughput exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file   bench/SelfOrganizingMapBenchmark.cpp
+ * @brief  Benchmarks of the spatial transformations, the euclidean distance matrix,
+ *         and a full training and mapping step of a single image.
+ *
+ * The neuron dimension and the dimension of the euclidean distance calculation are the
+ * defaults of Pink for the given image dimension and number of rotations. The sizes are
+ * limited to combinations with less than about 200 MB of memory.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <omp.h>
+#include <vector>
+
+#include "SelfOrganizingMapLib/CartesianLayout.h"
+#include "SelfOrganizingMapLib/Data.h"
+#include "SelfOrganizingMapLib/generate_euclidean_distance_matrix.h"
+#include "SelfOrganizingMapLib/generate_rotated_images.h"
+#include "SelfOrganizingMapLib/Mapper.h"
+#include "SelfOrganizingMapLib/SOM.h"
+#include "SelfOrganizingMapLib/Trainer.h"
+#include "UtilitiesLib/DistributionFunctor.h"
+#include "UtilitiesLib/EuclideanDistanceBackend.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+namespace {
+
+typedef Data<CartesianLayout<2>, float> DataType;
+typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+
+/// Same as the defaults of InputData
+uint32_t get_neuron_dim(uint32_t image_dim, uint32_t number_of_rotations)
+{
+    if (number_of_rotations == 1) return image_dim;
+    return 2 * image_dim / std::sqrt(2.0) + 1;
+}
+
+uint32_t get_euclidean_distance_dim(uint32_t image_dim, uint32_t number_of_rotations)
+{
+    if (number_of_rotations == 1) return image_dim;
+    return image_dim * std::sqrt(2.0) / 2.0;
+}
+
+/// A few different images, which are used in turn
+std::vector<DataType> get_images(uint32_t image_dim, uint32_t number_of_images = 4)
+{
+    std::vector<DataType> images;
+    for (uint32_t i = 0; i != number_of_images; ++i) {
+        std::vector<float> v(image_dim * image_dim);
+        fill_random_uniform(&v[0], v.size(), i);
+        images.push_back(DataType({image_dim, image_dim}, v));
+    }
+    return images;
+}
+
+SOMType get_som(uint32_t som_dim, uint32_t neuron_dim)
+{
+    std::vector<float> v(som_dim * som_dim * neuron_dim * neuron_dim);
+    fill_random_uniform(&v[0], v.size(), 42);
+    return SOMType({som_dim, som_dim}, {neuron_dim, neuron_dim}, v);
+}
+
+void set_counters(benchmark::State& state, uint32_t som_dim, uint32_t image_dim, uint32_t number_of_rotations)
+{
+    state.SetItemsProcessed(state.iterations());
+    state.counters["som_dim"] = som_dim;
+    state.counters["image_dim"] = image_dim;
+    state.counters["neuron_dim"] = get_neuron_dim(image_dim, number_of_rotations);
+    state.counters["rotations"] = number_of_rotations;
+}
+
+} // namespace
+
+/// Arguments: image dimension, number of rotations
+static void BM_generate_rotated_images(benchmark::State& state)
+{
+    uint32_t image_dim = state.range(0);
+    uint32_t number_of_rotations = state.range(1);
+    uint32_t neuron_dim = get_neuron_dim(image_dim, number_of_rotations);
+    auto&& images = get_images(image_dim);
+    BilinearRotationPlanCache rotation_plans(neuron_dim, number_of_rotations, Interpolation::BILINEAR);
+    auto&& plans = rotation_plans.get(image_dim);
+
+    size_t n = 0;
+    for (auto _ : state) {
+        auto&& rotated_images = generate_rotated_images(images[n++ % images.size()], number_of_rotations,
+            true, Interpolation::BILINEAR, neuron_dim, plans);
+        benchmark::DoNotOptimize(rotated_images.data());
+    }
+    set_counters(state, 0, image_dim, number_of_rotations);
+}
+BENCHMARK(BM_generate_rotated_images)
+    ->Args({64, 1})->Args({64, 4})->Args({64, 360})->Args({64, 720})
+    ->Args({128, 360})->Args({128, 720})
+    ->Args({256, 4})->Args({256, 90})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Arguments: SOM dimension, image dimension, number of rotations, backend (0 = direct, 1 = gemm)
+static void BM_generate_euclidean_distance_matrix(benchmark::State& state)
+{
+    uint32_t som_dim = state.range(0);
+    uint32_t image_dim = state.range(1);
+    uint32_t number_of_rotations = state.range(2);
+    auto backend = state.range(3) ? EuclideanDistanceBackend::GEMM : EuclideanDistanceBackend::DIRECT;
+    uint32_t neuron_dim = get_neuron_dim(image_dim, number_of_rotations);
+    uint32_t number_of_spatial_transformations = 2 * number_of_rotations;
+
+    auto&& som = get_som(som_dim, neuron_dim);
+    auto&& rotated_images = generate_rotated_images(get_images(image_dim, 1)[0], number_of_rotations,
+        true, Interpolation::BILINEAR, neuron_dim);
+    std::vector<float> euclidean_distance_matrix(som.get_number_of_neurons());
+    std::vector<uint32_t> best_rotation_matrix(som.get_number_of_neurons());
+
+    for (auto _ : state) {
+        generate_euclidean_distance_matrix(euclidean_distance_matrix, best_rotation_matrix,
+            som.get_number_of_neurons(), som.get_data_pointer(), neuron_dim, number_of_spatial_transformations,
+            rotated_images, get_euclidean_distance_dim(image_dim, number_of_rotations), backend);
+        benchmark::DoNotOptimize(euclidean_distance_matrix.data());
+    }
+    set_counters(state, som_dim, image_dim, number_of_rotations);
+}
+BENCHMARK(BM_generate_euclidean_distance_matrix)
+    ->ArgsProduct({{10}, {64}, {1, 360, 720}, {0, 1}})
+    ->ArgsProduct({{50}, {64}, {8, 360}, {0, 1}})
+    ->ArgsProduct({{10}, {128}, {360}, {0, 1}})
+    ->ArgsProduct({{10}, {256}, {4}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Strong scaling of the euclidean distance matrix from one thread to the number of processors
+/// Arguments: number of threads, backend (0 = direct, 1 = gemm)
+static void BM_generate_euclidean_distance_matrix_scaling(benchmark::State& state)
+{
+    uint32_t number_of_neurons = 100, neuron_dim = 45, number_of_spatial_transformations = 720;
+    uint32_t euclidean_distance_dim = 31;
+    auto backend = state.range(1) ? EuclideanDistanceBackend::GEMM : EuclideanDistanceBackend::DIRECT;
+
+    std::vector<float> som(number_of_neurons * neuron_dim * neuron_dim);
+    fill_random_uniform(&som[0], som.size(), 1);
+    std::vector<float> rotated_images(number_of_spatial_transformations * neuron_dim * neuron_dim);
+    fill_random_uniform(&rotated_images[0], rotated_images.size(), 2);
+    std::vector<float> euclidean_distance_matrix(number_of_neurons);
+    std::vector<uint32_t> best_rotation_matrix(number_of_neurons);
+
+    int max_threads = omp_get_max_threads();
+    omp_set_num_threads(state.range(0));
+    for (auto _ : state) {
+        generate_euclidean_distance_matrix(euclidean_distance_matrix, best_rotation_matrix,
+            number_of_neurons, &som[0], neuron_dim, number_of_spatial_transformations,
+            rotated_images, euclidean_distance_dim, backend);
+        benchmark::DoNotOptimize(euclidean_distance_matrix.data());
+    }
+    omp_set_num_threads(max_threads);
+    state.counters["threads"] = state.range(0);
+}
+BENCHMARK(BM_generate_euclidean_distance_matrix_scaling)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+        for (int backend : {0, 1}) {
+            for (int number_of_threads = 1; number_of_threads <= omp_get_num_procs(); number_of_threads *= 2) {
+                b->Args({number_of_threads, backend});
+            }
+        }
+    })
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Arguments: SOM dimension, image dimension, number of rotations
+static void BM_trainer_step(benchmark::State& state)
+{
+    typedef Trainer<CartesianLayout<2>, CartesianLayout<2>, float, false> TrainerType;
+
+    uint32_t som_dim = state.range(0);
+    uint32_t image_dim = state.range(1);
+    uint32_t number_of_rotations = state.range(2);
+    uint32_t neuron_dim = get_neuron_dim(image_dim, number_of_rotations);
+
+    auto&& images = get_images(image_dim);
+    auto&& som = get_som(som_dim, neuron_dim);
+    TrainerType trainer(som, GaussianFunctor(1.1, 0.2), 0, number_of_rotations, true, -1.0,
+        Interpolation::BILINEAR, get_euclidean_distance_dim(image_dim, number_of_rotations));
+
+    size_t n = 0;
+    for (auto _ : state) {
+        trainer(images[n++ % images.size()]);
+    }
+    benchmark::DoNotOptimize(som.get_data_pointer());
+    set_counters(state, som_dim, image_dim, number_of_rotations);
+}
+
+/// Arguments: SOM dimension, image dimension, number of rotations
+static void BM_mapper_step(benchmark::State& state)
+{
+    typedef Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false> MapperType;
+
+    uint32_t som_dim = state.range(0);
+    uint32_t image_dim = state.range(1);
+    uint32_t number_of_rotations = state.range(2);
+    uint32_t neuron_dim = get_neuron_dim(image_dim, number_of_rotations);
+
+    auto&& images = get_images(image_dim);
+    auto&& som = get_som(som_dim, neuron_dim);
+    MapperType mapper(som, 0, number_of_rotations, true, Interpolation::BILINEAR,
+        get_euclidean_distance_dim(image_dim, number_of_rotations));
+
+    size_t n = 0;
+    for (auto _ : state) {
+        auto&& result = mapper(images[n++ % images.size()]);
+        benchmark::DoNotOptimize(std::get<0>(result).data());
+    }
+    set_counters(state, som_dim, image_dim, number_of_rotations);
+}
+
+/// Representative sizes of a single training or mapping step
+#define PINK_STEP_ARGUMENTS \
+    ->Args({10, 64, 1})->Args({10, 64, 360})->Args({10, 64, 720}) \
+    ->Args({50, 64, 8})->Args({50, 64, 360}) \
+    ->Args({10, 128, 360}) \
+    ->Args({10, 256, 4}) \
+    ->Unit(benchmark::kMillisecond)->UseRealTime()
+
+BENCHMARK(BM_trainer_step) PINK_STEP_ARGUMENTS;
+BENCHMARK(BM_mapper_step) PINK_STEP_ARGUMENTS;
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+
+"""
+PINK convert a data file into a chunked data file with LZ4 compressed chunks
+"""
+
+__author__ = "Bernd Doser"
+__email__ = "bernd.doser@h-its.org"
+__license__ = "GPLv3"
+
+import argparse
+import struct
+import tools
+
+# Size in bytes of one value for the supported data types
+DATA_TYPE_SIZES = {0: 4, 6: 1, 7: 2, 10: 2}
+
+
+def lz4_compress(data):
+    """ Compress data into a single LZ4 block (greedy matching, slow fallback without python-lz4) """
+
+    try:
+        import lz4.block
+        return lz4.block.compress(data, store_size=False)
+    except ImportError:
+        pass
+
+    def write_length(output, length):
+        while length >= 255:
+            output.append(255)
+            length -= 255
+        output.append(length)
+
+    def write_sequence(output, literals, offset, match_length):
+        ml = match_length - 4 if match_length else 0
+        output.append((min(len(literals), 15) << 4) | min(ml, 15))
+        if len(literals) >= 15:
+            write_length(output, len(literals) - 15)
+        output += literals
+        if match_length:
+            output += struct.pack('<H', offset)
+            if ml >= 15:
+                write_length(output, ml - 15)
+
+    output = bytearray()
+    size = len(data)
+    table = {}
+    anchor = 0
+    ip = 0
+    while ip + 12 <= size:
+        sequence = data[ip:ip + 4]
+        ref = table.get(sequence)
+        table[sequence] = ip
+        if ref is None or ip - ref > 65535:
+            ip += 1
+            continue
+        length = 4
+        while ip + length < size - 5 and data[ref + length] == data[ip + length]:
+            length += 1
+        write_sequence(output, data[anchor:ip], ip - ref, length)
+        ip += length
+        anchor = ip
+    write_sequence(output, data[anchor:], 0, 0)
+    return bytes(output)
+
+
+def read_header_comments(input):
+    """ Return the header lines including '# END OF HEADER', the input is positioned behind them """
+
+    header = b''
+    for line in input:
+        header += line
+        if line == b'# END OF HEADER\n':
+            break
+    else:
+        header = b''
+    input.seek(len(header))
+    return header
+
+
+def main():
+    """ Main routine of PINK compress data file """
+
+    parser = argparse.ArgumentParser(description='PINK compress data file')
+    parser.add_argument('data', help='Data input file (.bin)', action=tools.check_extension({'bin'}))
+    parser.add_argument('-o', '--output', required=True, help='Chunked data output file')
+    parser.add_argument('-c', '--chunk-size', type=int, default=256, help='Number of entries per chunk')
+    args = parser.parse_args()
+
+    input = open(args.data, 'rb')
+    header = read_header_comments(input)
+
+    # <file format version> 0 <data-type> <number of entries> <data layout> <data>
+    version, file_type, data_type, number_of_entries, layout, dimensionality = struct.unpack('i' * 6, input.read(4 * 6))
+    dimensions = struct.unpack('i' * dimensionality, input.read(4 * dimensionality))
+    if file_type != 0:
+        raise ValueError('File type {} is not an uncompressed data file'.format(file_type))
+    if data_type not in DATA_TYPE_SIZES:
+        raise ValueError('Data type {} is not supported'.format(data_type))
+
+    entry_size = DATA_TYPE_SIZES[data_type]
+    for dimension in dimensions:
+        entry_size *= dimension
+    number_of_chunks = (number_of_entries + args.chunk_size - 1) // args.chunk_size
+
+    # <file format version> 4 <data-type> <number of entries> <data layout> <entries per chunk>
+    # <number of chunks> <chunk offsets> <chunks>
+    output = open(args.output, 'wb')
+    output.write(header)
+    output.write(struct.pack('i' * 6, version, 4, data_type, number_of_entries, layout, dimensionality))
+    output.write(struct.pack('i' * dimensionality, *dimensions))
+    output.write(struct.pack('i' * 2, args.chunk_size, number_of_chunks))
+
+    # The chunks are written as they are compressed behind placeholder offsets, which are written at the end
+    offsets_position = output.tell()
+    output.write(bytes(8 * (number_of_chunks + 1)))
+    offsets = [0]
+    for chunk in range(number_of_chunks):
+        number_of_chunk_entries = min(args.chunk_size, number_of_entries - chunk * args.chunk_size)
+        compressed_chunk = lz4_compress(input.read(number_of_chunk_entries * entry_size))
+        output.write(compressed_chunk)
+        offsets.append(offsets[-1] + len(compressed_chunk))
+
+    output.seek(offsets_position)
+    output.write(struct.pack('Q' * len(offsets), *offsets))
+    output.close()
+
+    print('Compression ratio: {:.2f}'.format(number_of_entries * entry_size / max(offsets[-1], 1)))
+    print('All done.')
+
+main()
@@ -6,6 +6,16 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "UtilitiesLib/SIMDLevel.h"
+
+#ifdef PINK_USE_X86_SIMD
+    #include "euclidean_distance_avx.h"
+#endif
+
 namespace pink {
 
 /// Returns dot product of array with itself
@@ -17,27 +27,85 @@ T dot(std::vector<T> const& v)
     return dot;
 }
 
+/// Returns dot product of array with itself
+template <typename T>
+T dot(T const *v, int length)
+{
+    T dot = 0;
+    for (int i = 0; i < length; ++i) dot += v[i] * v[i];
+    return dot;
+}
+
+/// Scalar version of @euclidean_distance_square
+template <typename T>
+T euclidean_distance_square_scalar(T const *a, T const *b, int length)
+{
+    T sum = 0;
+    for (int i = 0; i < length; ++i) {
+        T diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+/// Scalar version of @euclidean_distance_square_offset
+template <typename T>
+T euclidean_distance_square_offset_scalar(T const *a, T const *b, int image_dim, int euclidean_distance_dim)
+{
+    int offset = (image_dim - euclidean_distance_dim) / 2;
+    T sum = 0;
+    for (int i = 0; i < euclidean_distance_dim; ++i) {
+        T const *pa = a + (i + offset) * image_dim + offset;
+        T const *pb = b + (i + offset) * image_dim + offset;
+        for (int j = 0; j < euclidean_distance_dim; ++j) {
+            T diff = pa[j] - pb[j];
+            sum += diff * diff;
+        }
+    }
+    return sum;
+}
+
 /// Same as @euclidean_distance but without square root for speed (sum((a[i] - b[i])^2))
 template <typename T>
 T euclidean_distance_square(T const *a, T const *b, int length)
 {
-    std::vector<T> diff(length);
-    for (int i = 0; i < length; ++i) diff[i] = a[i] - b[i];
-    return dot(diff);
+    return euclidean_distance_square_scalar(a, b, length);
 }
 
-/// Same as @euclidean_distance but without square root for speed (sum((a[i] - b[i])^2))
+/// Same as @euclidean_distance_square but only for the centered quadratic window of
+/// dimension euclidean_distance_dim of two quadratic images with dimension image_dim
 template <typename T>
 T euclidean_distance_square_offset(T const *a, T const *b, int image_dim, int euclidean_distance_dim)
 {
-    uint32_t offset = (image_dim - euclidean_distance_dim) * 0.5;
-    std::vector<T> diff(euclidean_distance_dim * euclidean_distance_dim);
-    for (int i = 0; i < euclidean_distance_dim; ++i)
-      for (int j = 0; j < euclidean_distance_dim; ++j)
-        diff[i * euclidean_distance_dim + j] = a[(i + offset) * image_dim + j + offset] - b[(i + offset) * image_dim + j + offset];
-    return dot(diff);
+    return euclidean_distance_square_offset_scalar(a, b, image_dim, euclidean_distance_dim);
 }
 
+#ifdef PINK_USE_X86_SIMD
+
+/// Runtime dispatch to the best available vector unit
+template <>
+inline float euclidean_distance_square(float const *a, float const *b, int length)
+{
+    switch (get_simd_level()) {
+        case SIMDLevel::AVX512: return euclidean_distance_square_avx512(a, b, length);
+        case SIMDLevel::AVX2: return euclidean_distance_square_avx2(a, b, length);
+        default: return euclidean_distance_square_scalar(a, b, length);
+    }
+}
+
+/// Runtime dispatch to the best available vector unit
+template <>
+inline float euclidean_distance_square_offset(float const *a, float const *b, int image_dim, int euclidean_distance_dim)
+{
+    switch (get_simd_level()) {
+        case SIMDLevel::AVX512: return euclidean_distance_square_offset_avx512(a, b, image_dim, euclidean_distance_dim);
+        case SIMDLevel::AVX2: return euclidean_distance_square_offset_avx2(a, b, image_dim, euclidean_distance_dim);
+        default: return euclidean_distance_square_offset_scalar(a, b, image_dim, euclidean_distance_dim);
+    }
+}
+
+#endif
+
 /// Returns euclidean distance of two arrays (sqrt(sum((a[i] - b[i])^2))
 template <typename T>
 T euclidean_distance(T const *a, T const *b, int length)
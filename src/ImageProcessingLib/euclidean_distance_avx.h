@@ -0,0 +1,123 @@
+/**
+ * @file   ImageProcessingLib/euclidean_distance_avx.h
+ * @brief  AVX2 and AVX-512 kernels for the squared euclidean distance.
+ *
+ * The kernels are compiled with function-level target attributes, so the rest of the
+ * code base does not need any architecture flags. The caller is responsible to check
+ * the CPU capabilities before (see get_simd_level).
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <immintrin.h>
+
+namespace pink {
+
+/// Adds sum((a[i] - b[i])^2) of a contiguous row to the vector accumulator
+__attribute__((target("avx2,fma")))
+inline __m256 accumulate_distance_square_avx2(float const *a, float const *b, int length, __m256 sum)
+{
+    int i = 0;
+    __m256 sum2 = _mm256_setzero_ps();
+    for (; i + 16 <= length; i += 16) {
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d2 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        sum = _mm256_fmadd_ps(d1, d1, sum);
+        sum2 = _mm256_fmadd_ps(d2, d2, sum2);
+    }
+    for (; i + 8 <= length; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        sum = _mm256_fmadd_ps(d, d, sum);
+    }
+    if (i < length) {
+        __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(length - i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256 d = _mm256_sub_ps(_mm256_maskload_ps(a + i, mask), _mm256_maskload_ps(b + i, mask));
+        sum = _mm256_fmadd_ps(d, d, sum);
+    }
+    return _mm256_add_ps(sum, sum2);
+}
+
+__attribute__((target("avx2,fma")))
+inline float horizontal_sum_avx2(__m256 v)
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2,fma")))
+inline float euclidean_distance_square_avx2(float const *a, float const *b, int length)
+{
+    return horizontal_sum_avx2(accumulate_distance_square_avx2(a, b, length, _mm256_setzero_ps()));
+}
+
+__attribute__((target("avx2,fma")))
+inline float euclidean_distance_square_offset_avx2(float const *a, float const *b, int image_dim, int euclidean_distance_dim)
+{
+    int offset = (image_dim - euclidean_distance_dim) / 2;
+    __m256 sum = _mm256_setzero_ps();
+    for (int i = 0; i < euclidean_distance_dim; ++i) {
+        int row = (i + offset) * image_dim + offset;
+        sum = accumulate_distance_square_avx2(a + row, b + row, euclidean_distance_dim, sum);
+    }
+    return horizontal_sum_avx2(sum);
+}
+
+/// Adds sum((a[i] - b[i])^2) of a contiguous row to the vector accumulator
+__attribute__((target("avx512f")))
+inline __m512 accumulate_distance_square_avx512(float const *a, float const *b, int length, __m512 sum)
+{
+    int i = 0;
+    __m512 sum2 = _mm512_setzero_ps();
+    for (; i + 32 <= length; i += 32) {
+        __m512 d1 = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        __m512 d2 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16));
+        sum = _mm512_fmadd_ps(d1, d1, sum);
+        sum2 = _mm512_fmadd_ps(d2, d2, sum2);
+    }
+    for (; i + 16 <= length; i += 16) {
+        __m512 d = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        sum = _mm512_fmadd_ps(d, d, sum);
+    }
+    if (i < length) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (length - i)) - 1);
+        __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+        sum = _mm512_fmadd_ps(d, d, sum);
+    }
+    return _mm512_add_ps(sum, sum2);
+}
+
+/// Own reduction instead of _mm512_reduce_add_ps, which triggers -Wuninitialized with GCC 12
+__attribute__((target("avx512f")))
+inline float horizontal_sum_avx512(__m512 v)
+{
+    alignas(64) float tmp[16];
+    _mm512_store_ps(tmp, v);
+    float sum = 0.0f;
+    for (int i = 0; i < 16; ++i) sum += tmp[i];
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+inline float euclidean_distance_square_avx512(float const *a, float const *b, int length)
+{
+    return horizontal_sum_avx512(accumulate_distance_square_avx512(a, b, length, _mm512_setzero_ps()));
+}
+
+__attribute__((target("avx512f")))
+inline float euclidean_distance_square_offset_avx512(float const *a, float const *b, int image_dim, int euclidean_distance_dim)
+{
+    int offset = (image_dim - euclidean_distance_dim) / 2;
+    __m512 sum = _mm512_setzero_ps();
+    for (int i = 0; i < euclidean_distance_dim; ++i) {
+        int row = (i + offset) * image_dim + offset;
+        sum = accumulate_distance_square_avx512(a + row, b + row, euclidean_distance_dim, sum);
+    }
+    return horizontal_sum_avx512(sum);
+}
+
+} // namespace pink
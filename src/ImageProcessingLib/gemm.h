@@ -0,0 +1,217 @@
+/**
+ * @file   ImageProcessingLib/gemm.h
+ * @brief  Cache-blocked matrix multiplication C = A * B^T for row-major A and B.
+ *
+ * A has the dimension m x k, B has the dimension n x k, and C the dimension m x n.
+ * Because both operands are stored row-major with contiguous k, each element of C
+ * is a contiguous dot product. The micro-kernels compute a tile of MR x NR dot products
+ * at once to reuse every loaded vector of A and B several times.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "UtilitiesLib/SIMDLevel.h"
+
+#ifdef PINK_USE_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+namespace pink {
+
+/// Block sizes of the cache blocking
+struct GemmBlocking
+{
+    /// Rows of A sharing one block of B
+    static const int MC = 48;
+
+    /// Rows of B kept in L2 cache
+    static const int NC = 64;
+
+    /// Length of the dot product chunk
+    static const int KC = 1024;
+};
+
+/// Scalar micro-kernel: C[MR x NR] += A[MR x kc] * B[NR x kc]^T
+template <int MR, int NR, typename T>
+void gemm_nt_micro_kernel_scalar(T const *a, T const *b, T *c, int kc, int lda, int ldb, int ldc)
+{
+    T acc[MR][NR] = {};
+    for (int p = 0; p < kc; ++p) {
+        for (int i = 0; i < MR; ++i) {
+            for (int j = 0; j < NR; ++j) {
+                acc[i][j] += a[i * lda + p] * b[j * ldb + p];
+            }
+        }
+    }
+    for (int i = 0; i < MR; ++i) {
+        for (int j = 0; j < NR; ++j) {
+            c[i * ldc + j] += acc[i][j];
+        }
+    }
+}
+
+#ifdef PINK_USE_X86_SIMD
+
+/// AVX2 micro-kernel: C[MR x NR] += A[MR x kc] * B[NR x kc]^T
+template <int MR, int NR>
+__attribute__((target("avx2,fma")))
+inline void gemm_nt_micro_kernel_avx2(float const *a, float const *b, float *c, int kc, int lda, int ldb, int ldc)
+{
+    __m256 acc[MR][NR];
+    for (int i = 0; i < MR; ++i)
+        for (int j = 0; j < NR; ++j) acc[i][j] = _mm256_setzero_ps();
+
+    int p = 0;
+    for (; p + 8 <= kc; p += 8) {
+        __m256 va[MR];
+        for (int i = 0; i < MR; ++i) va[i] = _mm256_loadu_ps(a + i * lda + p);
+        for (int j = 0; j < NR; ++j) {
+            __m256 vb = _mm256_loadu_ps(b + j * ldb + p);
+            for (int i = 0; i < MR; ++i) acc[i][j] = _mm256_fmadd_ps(va[i], vb, acc[i][j]);
+        }
+    }
+    if (p < kc) {
+        __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(kc - p), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256 va[MR];
+        for (int i = 0; i < MR; ++i) va[i] = _mm256_maskload_ps(a + i * lda + p, mask);
+        for (int j = 0; j < NR; ++j) {
+            __m256 vb = _mm256_maskload_ps(b + j * ldb + p, mask);
+            for (int i = 0; i < MR; ++i) acc[i][j] = _mm256_fmadd_ps(va[i], vb, acc[i][j]);
+        }
+    }
+
+    for (int i = 0; i < MR; ++i) {
+        for (int j = 0; j < NR; ++j) {
+            __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc[i][j]), _mm256_extractf128_ps(acc[i][j], 1));
+            s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+            s = _mm_add_ss(s, _mm_movehdup_ps(s));
+            c[i * ldc + j] += _mm_cvtss_f32(s);
+        }
+    }
+}
+
+/// AVX-512 micro-kernel: C[MR x NR] += A[MR x kc] * B[NR x kc]^T
+template <int MR, int NR>
+__attribute__((target("avx512f")))
+inline void gemm_nt_micro_kernel_avx512(float const *a, float const *b, float *c, int kc, int lda, int ldb, int ldc)
+{
+    __m512 acc[MR][NR];
+    for (int i = 0; i < MR; ++i)
+        for (int j = 0; j < NR; ++j) acc[i][j] = _mm512_setzero_ps();
+
+    int p = 0;
+    for (; p + 16 <= kc; p += 16) {
+        __m512 va[MR];
+        for (int i = 0; i < MR; ++i) va[i] = _mm512_loadu_ps(a + i * lda + p);
+        for (int j = 0; j < NR; ++j) {
+            __m512 vb = _mm512_loadu_ps(b + j * ldb + p);
+            for (int i = 0; i < MR; ++i) acc[i][j] = _mm512_fmadd_ps(va[i], vb, acc[i][j]);
+        }
+    }
+    if (p < kc) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (kc - p)) - 1);
+        __m512 va[MR];
+        for (int i = 0; i < MR; ++i) va[i] = _mm512_maskz_loadu_ps(mask, a + i * lda + p);
+        for (int j = 0; j < NR; ++j) {
+            __m512 vb = _mm512_maskz_loadu_ps(mask, b + j * ldb + p);
+            for (int i = 0; i < MR; ++i) acc[i][j] = _mm512_fmadd_ps(va[i], vb, acc[i][j]);
+        }
+    }
+
+    alignas(64) float tmp[16];
+    for (int i = 0; i < MR; ++i) {
+        for (int j = 0; j < NR; ++j) {
+            _mm512_store_ps(tmp, acc[i][j]);
+            float sum = 0.0f;
+            for (int l = 0; l < 16; ++l) sum += tmp[l];
+            c[i * ldc + j] += sum;
+        }
+    }
+}
+
+#endif
+
+/// Multiplies one MC x NC block of C over a kc chunk using the micro-kernels
+/// with register tile MR x NR and the edge kernels for the remainders.
+template <int MR, int NR, typename T, typename Kernel, typename EdgeKernel>
+void gemm_nt_block(T const *a, T const *b, T *c, int mc, int nc, int kc, int lda, int ldb, int ldc,
+    Kernel kernel, EdgeKernel edge_kernel)
+{
+    int i = 0;
+    for (; i + MR <= mc; i += MR) {
+        int j = 0;
+        for (; j + NR <= nc; j += NR) kernel(a + i * lda, b + j * ldb, c + i * ldc + j, kc, lda, ldb, ldc);
+        for (; j < nc; ++j)
+            for (int ii = i; ii < i + MR; ++ii) edge_kernel(a + ii * lda, b + j * ldb, c + ii * ldc + j, kc, lda, ldb, ldc);
+    }
+    for (; i < mc; ++i)
+        for (int j = 0; j < nc; ++j) edge_kernel(a + i * lda, b + j * ldb, c + i * ldc + j, kc, lda, ldb, ldc);
+}
+
+/// Parallel loop over all MC x NC blocks of C
+template <typename T, typename Block>
+void gemm_nt_parallel(T *c, int m, int n, int k, Block block)
+{
+    const int MC = GemmBlocking::MC;
+    const int NC = GemmBlocking::NC;
+    const int KC = GemmBlocking::KC;
+
+    std::fill(c, c + static_cast<int64_t>(m) * n, T(0));
+
+    int number_of_row_blocks = (m + MC - 1) / MC;
+    int number_of_column_blocks = (n + NC - 1) / NC;
+
+    #pragma omp parallel for collapse(2) schedule(dynamic)
+    for (int ib = 0; ib < number_of_row_blocks; ++ib) {
+        for (int jb = 0; jb < number_of_column_blocks; ++jb) {
+            int i0 = ib * MC, j0 = jb * NC;
+            int mc = std::min(MC, m - i0), nc = std::min(NC, n - j0);
+            for (int p0 = 0; p0 < k; p0 += KC) {
+                block(i0, j0, p0, mc, nc, std::min(KC, k - p0));
+            }
+        }
+    }
+}
+
+/// C = A * B^T (generic scalar version)
+template <typename T>
+void gemm_nt(T const *a, T const *b, T *c, int m, int n, int k)
+{
+    gemm_nt_parallel(c, m, n, k, [=](int i0, int j0, int p0, int mc, int nc, int kc) {
+        gemm_nt_block<4, 4>(a + i0 * k + p0, b + j0 * k + p0, c + i0 * n + j0, mc, nc, kc, k, k, n,
+            gemm_nt_micro_kernel_scalar<4, 4, T>, gemm_nt_micro_kernel_scalar<1, 1, T>);
+    });
+}
+
+#ifdef PINK_USE_X86_SIMD
+
+/// C = A * B^T with runtime dispatch to the best available vector unit
+template <>
+inline void gemm_nt(float const *a, float const *b, float *c, int m, int n, int k)
+{
+    SIMDLevel level = get_simd_level();
+    gemm_nt_parallel(c, m, n, k, [=](int i0, int j0, int p0, int mc, int nc, int kc) {
+        float const *pa = a + i0 * k + p0;
+        float const *pb = b + j0 * k + p0;
+        float *pc = c + i0 * n + j0;
+        if (level == SIMDLevel::AVX512)
+            gemm_nt_block<4, 6>(pa, pb, pc, mc, nc, kc, k, k, n,
+                gemm_nt_micro_kernel_avx512<4, 6>, gemm_nt_micro_kernel_avx512<1, 1>);
+        else if (level == SIMDLevel::AVX2)
+            gemm_nt_block<3, 4>(pa, pb, pc, mc, nc, kc, k, k, n,
+                gemm_nt_micro_kernel_avx2<3, 4>, gemm_nt_micro_kernel_avx2<1, 1>);
+        else
+            gemm_nt_block<4, 4>(pa, pb, pc, mc, nc, kc, k, k, n,
+                gemm_nt_micro_kernel_scalar<4, 4, float>, gemm_nt_micro_kernel_scalar<1, 1, float>);
+    });
+}
+
+#endif
+
+} // namespace pink
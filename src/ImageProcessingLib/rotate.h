@@ -6,8 +6,15 @@
 
 #pragma once
 
+#include <cmath>
+
 #include "UtilitiesLib/Interpolation.h"
 #include "UtilitiesLib/pink_exception.h"
+#include "UtilitiesLib/SIMDLevel.h"
+
+#ifdef PINK_USE_X86_SIMD
+    #include "rotate_avx.h"
+#endif
 
 namespace pink {
 
@@ -61,11 +68,32 @@ void rotate_bilinear(T const* src, T *dst, int src_height, int src_width, int ds
     }
 }
 
+/// Vectorized version of @rotate_bilinear if available, the results are identical
+template <typename T>
+void rotate_bilinear_vectorized(T const* src, T *dst, int src_height, int src_width, int dst_height, int dst_width, float alpha)
+{
+    rotate_bilinear(src, dst, src_height, src_width, dst_height, dst_width, alpha);
+}
+
+#ifdef PINK_USE_X86_SIMD
+
+/// Runtime dispatch to the best available vector unit
+template <>
+inline void rotate_bilinear_vectorized(float const* src, float *dst, int src_height, int src_width, int dst_height, int dst_width, float alpha)
+{
+    if (get_simd_level() != SIMDLevel::SCALAR)
+        rotate_bilinear_avx2(src, dst, src_height, src_width, dst_height, dst_width, alpha);
+    else
+        rotate_bilinear(src, dst, src_height, src_width, dst_height, dst_width, alpha);
+}
+
+#endif
+
 template <typename T>
 void rotate(T const* src, T *dst, int src_height, int src_width, int dst_height, int dst_width, float alpha, Interpolation interpolation)
 {
     if (interpolation == Interpolation::BILINEAR)
-        rotate_bilinear(src, dst, src_height, src_width, dst_height, dst_width, alpha);
+        rotate_bilinear_vectorized(src, dst, src_height, src_width, dst_height, dst_width, alpha);
     else {
         throw pink::exception("rotate: unknown interpolation\n");
     }
@@ -6,10 +6,13 @@
 
 #pragma once
 
+#include <algorithm>
+
 namespace pink {
 
+/// Reference version of @rotate_90_degrees with contiguous reads and strided writes
 template <typename T>
-void rotate_90_degrees(T *src, T *dst, int height, int width)
+void rotate_90_degrees_untiled(T *src, T *dst, int height, int width)
 {
     for (int x = 0; x < width; ++x) {
         for (int y = 0; y < height; ++y) {
@@ -18,4 +21,28 @@ void rotate_90_degrees(T *src, T *dst, int height, int width)
     }
 }
 
+/// Same as @rotate_90_degrees_untiled, but the image is processed in quadratic tiles
+/// of dimension TileDim, so that the strided writes of a tile stay in the L1 cache.
+template <int TileDim, typename T>
+void rotate_90_degrees_tiled(T *src, T *dst, int height, int width)
+{
+    for (int x0 = 0; x0 < width; x0 += TileDim) {
+        int x1 = std::min(x0 + TileDim, width);
+        for (int y0 = 0; y0 < height; y0 += TileDim) {
+            int y1 = std::min(y0 + TileDim, height);
+            for (int x = x0; x < x1; ++x) {
+                for (int y = y0; y < y1; ++y) {
+                    dst[(height-y-1)*width + x] = src[x*height + y];
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void rotate_90_degrees(T *src, T *dst, int height, int width)
+{
+    rotate_90_degrees_tiled<16>(src, dst, height, width);
+}
+
 } // namespace pink
@@ -0,0 +1,105 @@
+/**
+ * @file   ImageProcessingLib/rotate_avx.h
+ * @brief  AVX2 kernel for the bilinear rotation.
+ *
+ * Eight neighboring destination pixels of a row are calculated at once and the four
+ * source pixels of each destination pixel are gathered. The kernel is compiled without
+ * FMA to perform exactly the same floating point operations as @rotate_bilinear.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <cmath>
+#include <immintrin.h>
+
+namespace pink {
+
+__attribute__((target("avx2")))
+inline void rotate_bilinear_avx2(float const* src, float *dst, int src_height, int src_width, int dst_height, int dst_width, float alpha)
+{
+    const float cos_alpha = cos(alpha);
+    const float sin_alpha = sin(alpha);
+
+    // Center of src image
+    const float src_center_x = (src_width - 1) * 0.5;
+    const float src_center_y = (src_height - 1) * 0.5;
+
+    // Center of dst image
+    const float dst_center_x = (dst_width - 1) * 0.5;
+    const float dst_center_y = (dst_height - 1) * 0.5;
+
+    const __m256 v_cos_alpha = _mm256_set1_ps(cos_alpha);
+    const __m256 v_sin_alpha = _mm256_set1_ps(sin_alpha);
+    const __m256 v_src_center_x = _mm256_set1_ps(src_center_x);
+    const __m256 v_src_center_y = _mm256_set1_ps(src_center_y);
+    const __m256 v_dst_center_y = _mm256_set1_ps(dst_center_y);
+    const __m256 v_zero = _mm256_setzero_ps();
+    const __m256 v_one = _mm256_set1_ps(1.0f);
+    const __m256 v_src_x_max = _mm256_set1_ps(static_cast<float>(src_width - 1));
+    const __m256 v_src_y_max = _mm256_set1_ps(static_cast<float>(src_height - 1));
+    const __m256i vi_src_x_max = _mm256_set1_epi32(src_width - 1);
+    const __m256i vi_src_y_max = _mm256_set1_epi32(src_height - 1);
+    const __m256i vi_src_height = _mm256_set1_epi32(src_height);
+    const __m256i vi_one = _mm256_set1_epi32(1);
+    const __m256i vi_lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (int dst_x = 0; dst_x < dst_width; ++dst_x) {
+
+        __m256 v_dst_position_x = _mm256_set1_ps(static_cast<float>(dst_x) - dst_center_x);
+        __m256 v_x_cos = _mm256_mul_ps(v_dst_position_x, v_cos_alpha);
+        __m256 v_x_sin = _mm256_mul_ps(v_dst_position_x, v_sin_alpha);
+        float *dst_row = dst + dst_x * dst_height;
+
+        for (int dst_y = 0; dst_y < dst_height; dst_y += 8) {
+
+            __m256i vi_dst_y = _mm256_add_epi32(_mm256_set1_epi32(dst_y), vi_lane);
+            __m256 v_dst_position_y = _mm256_sub_ps(_mm256_cvtepi32_ps(vi_dst_y), v_dst_center_y);
+
+            __m256 src_position_x = _mm256_add_ps(_mm256_sub_ps(v_x_cos, _mm256_mul_ps(v_dst_position_y, v_sin_alpha)), v_src_center_x);
+            __m256 src_position_y = _mm256_add_ps(_mm256_add_ps(v_x_sin, _mm256_mul_ps(v_dst_position_y, v_cos_alpha)), v_src_center_y);
+
+            __m256 inside = _mm256_and_ps(
+                _mm256_and_ps(_mm256_cmp_ps(src_position_x, v_zero, _CMP_GE_OQ), _mm256_cmp_ps(src_position_x, v_src_x_max, _CMP_LE_OQ)),
+                _mm256_and_ps(_mm256_cmp_ps(src_position_y, v_zero, _CMP_GE_OQ), _mm256_cmp_ps(src_position_y, v_src_y_max, _CMP_LE_OQ)));
+
+            __m256i vi_src_x = _mm256_cvttps_epi32(src_position_x);
+            __m256i vi_src_y = _mm256_cvttps_epi32(src_position_y);
+
+            // At the upper border the weight of the next pixel is zero, so it is not read
+            __m256i vi_src_x_plus_1 = _mm256_min_epi32(_mm256_add_epi32(vi_src_x, vi_one), vi_src_x_max);
+            __m256i vi_src_y_plus_1 = _mm256_min_epi32(_mm256_add_epi32(vi_src_y, vi_one), vi_src_y_max);
+
+            __m256 rx = _mm256_sub_ps(src_position_x, _mm256_cvtepi32_ps(vi_src_x));
+            __m256 ry = _mm256_sub_ps(src_position_y, _mm256_cvtepi32_ps(vi_src_y));
+
+            __m256 cx = _mm256_sub_ps(v_one, rx);
+            __m256 cy = _mm256_sub_ps(v_one, ry);
+
+            __m256i row = _mm256_mullo_epi32(vi_src_x, vi_src_height);
+            __m256i row_plus_1 = _mm256_mullo_epi32(vi_src_x_plus_1, vi_src_height);
+
+            __m256 p00 = _mm256_mask_i32gather_ps(v_zero, src, _mm256_add_epi32(row, vi_src_y), inside, 4);
+            __m256 p01 = _mm256_mask_i32gather_ps(v_zero, src, _mm256_add_epi32(row, vi_src_y_plus_1), inside, 4);
+            __m256 p10 = _mm256_mask_i32gather_ps(v_zero, src, _mm256_add_epi32(row_plus_1, vi_src_y), inside, 4);
+            __m256 p11 = _mm256_mask_i32gather_ps(v_zero, src, _mm256_add_epi32(row_plus_1, vi_src_y_plus_1), inside, 4);
+
+            __m256 result = _mm256_mul_ps(_mm256_mul_ps(cx, cy), p00);
+            result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_mul_ps(cx, ry), p01));
+            result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_mul_ps(rx, cy), p10));
+            result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_mul_ps(rx, ry), p11));
+            result = _mm256_and_ps(result, inside);
+
+            if (dst_y + 8 <= dst_height) {
+                _mm256_storeu_ps(dst_row + dst_y, result);
+            } else {
+                __m256i store_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(dst_height), vi_dst_y);
+                _mm256_maskstore_ps(dst_row + dst_y, store_mask, result);
+            }
+        }
+    }
+}
+
+} // namespace pink
@@ -0,0 +1,126 @@
+/**
+ * @file   ImageProcessingLib/rotation_plan.h
+ * @brief  Precomputed bilinear rotation.
+ *
+ * The source positions and interpolation weights of a rotation only depend on the image
+ * dimensions and the angle. The plan stores them once, so that the rotation of an image
+ * is a single streaming pass of gathering and blending.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pink {
+
+/// Precomputed version of @rotate_bilinear with identical results
+class BilinearRotationPlan
+{
+public:
+
+    BilinearRotationPlan(int src_height, int src_width, int dst_height, int dst_width, float alpha)
+     : src_size(src_height * src_width),
+       entries(dst_height * dst_width)
+    {
+        const float cos_alpha = cos(alpha);
+        const float sin_alpha = sin(alpha);
+
+        // Center of src image
+        const float src_center_x = (src_width - 1) * 0.5;
+        const float src_center_y = (src_height - 1) * 0.5;
+
+        // Center of dst image
+        const float dst_center_x = (dst_width - 1) * 0.5;
+        const float dst_center_y = (dst_height - 1) * 0.5;
+
+        for (int dst_x = 0; dst_x < dst_width; ++dst_x) {
+            for (int dst_y = 0; dst_y < dst_height; ++dst_y) {
+
+                Entry& entry = entries[dst_x * dst_height + dst_y];
+
+                float dst_position_x = static_cast<float>(dst_x) - dst_center_x;
+                float dst_position_y = static_cast<float>(dst_y) - dst_center_y;
+
+                float src_position_x = dst_position_x * cos_alpha - dst_position_y * sin_alpha + src_center_x;
+                float src_position_y = dst_position_x * sin_alpha + dst_position_y * cos_alpha + src_center_y;
+
+                if (src_position_x < 0.0 or src_position_x > src_width - 1 or src_position_y < 0.0 or src_position_y > src_height - 1)
+                {
+                    entry.index[0] = outside;
+                    continue;
+                }
+
+                int src_x = src_position_x;
+                int src_y = src_position_y;
+
+                // At the upper border the weight of the next pixel is zero, so it is not read
+                int src_x_plus_1 = src_x + 1 < src_width ? src_x + 1 : src_x;
+                int src_y_plus_1 = src_y + 1 < src_height ? src_y + 1 : src_y;
+
+                float rx = src_position_x - src_x;
+                float ry = src_position_y - src_y;
+
+                float cx = 1.0 - rx;
+                float cy = 1.0 - ry;
+
+                entry.index[0] = src_x * src_height + src_y;
+                entry.index[1] = src_x * src_height + src_y_plus_1;
+                entry.index[2] = src_x_plus_1 * src_height + src_y;
+                entry.index[3] = src_x_plus_1 * src_height + src_y_plus_1;
+
+                entry.weight[0] = cx * cy;
+                entry.weight[1] = cx * ry;
+                entry.weight[2] = rx * cy;
+                entry.weight[3] = rx * ry;
+            }
+        }
+    }
+
+    /// Rotate src into dst
+    template <typename T>
+    void operator () (T const *src, T *dst) const
+    {
+        for (size_t i = 0; i < entries.size(); ++i) {
+            Entry const& entry = entries[i];
+            if (entry.index[0] == outside) {
+                dst[i] = 0.0;
+            } else {
+                dst[i] = entry.weight[0] * src[entry.index[0]]
+                       + entry.weight[1] * src[entry.index[1]]
+                       + entry.weight[2] * src[entry.index[2]]
+                       + entry.weight[3] * src[entry.index[3]];
+            }
+        }
+    }
+
+    /// Returns the number of pixels of the source image
+    auto get_src_size() const { return src_size; }
+
+    /// Returns the number of pixels of the destination image
+    auto get_dst_size() const { return entries.size(); }
+
+private:
+
+    /// Source indices and weights of a destination pixel
+    struct Entry
+    {
+        uint32_t index[4];
+        float weight[4];
+    };
+
+    /// Marker for destination pixels outside of the source image
+    static constexpr uint32_t outside = std::numeric_limits<uint32_t>::max();
+
+    size_t src_size;
+
+    /// Ordered as the destination pixels
+    std::vector<Entry> entries;
+};
+
+} // namespace pink
@@ -5,41 +5,79 @@
  * @author Bernd Doser, HITS gGmbH
  */
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <omp.h>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
+#include "SelfOrganizingMapLib/Checkpoint.h"
 #include "SelfOrganizingMapLib/Data.h"
 #include "SelfOrganizingMapLib/DataIO.h"
 #include "SelfOrganizingMapLib/DataIterator.h"
 #include "SelfOrganizingMapLib/FileIO.h"
 #include "SelfOrganizingMapLib/Mapper.h"
+#include "SelfOrganizingMapLib/MmapDataIterator.h"
+#include "SelfOrganizingMapLib/PrefetchPipeline.h"
 #include "SelfOrganizingMapLib/SOM.h"
 #include "SelfOrganizingMapLib/Trainer.h"
+#include "UtilitiesLib/AlignedAllocator.h"
+#include "UtilitiesLib/BufferedWriter.h"
 #include "UtilitiesLib/DistributionFunction.h"
 #include "UtilitiesLib/DistributionFunctor.h"
 #include "UtilitiesLib/InputData.h"
+#include "UtilitiesLib/PhaseTimer.h"
 #include "UtilitiesLib/pink_exception.h"
 #include "UtilitiesLib/ProgressBar.h"
 
 namespace pink {
 
-template <typename SOMLayout, typename DataLayout, typename T, bool UseGPU>
-void main_generic(InputData const& input_data)
+/// Training or mapping of the data given by the iterators
+template <typename SOMLayout, typename DataLayout, typename T, bool UseGPU, typename Iterator>
+void main_generic(InputData const& input_data, SOM<SOMLayout, DataLayout, T>& som,
+    Iterator& iter_data_cur, Iterator const& iter_data_end)
 {
-    if (input_data.verbose)
-        std::cout << "SOM layout:  " << SOMLayout::type  << "<" << static_cast<int>(SOMLayout::dimensionality)  << ">" << "\n"
-                  << "Data layout: " << DataLayout::type << "<" << static_cast<int>(DataLayout::dimensionality) << ">" << "\n"
-                  << std::endl;
+    // The phase times are written as single-line JSON objects at every progress step and at the end
+    std::unique_ptr<std::ofstream> metrics_file;
+    if (!input_data.metrics_filename.empty()) {
+        metrics_file.reset(new std::ofstream(input_data.metrics_filename));
+        if (!*metrics_file) throw pink::exception("Error opening " + input_data.metrics_filename);
+        PhaseTimerRegistry::instance().reset();
+        PhaseTimerRegistry::instance().enable();
+    }
+    uint64_t processed_entries = 0;
+    auto&& write_metrics = [&](std::string const& event) {
+        if (metrics_file) PhaseTimerRegistry::instance().write_json(*metrics_file, event, processed_entries);
+    };
 
-    SOM<SOMLayout, DataLayout, T> som(input_data);
+    if (input_data.executionPath == ExecutionPath::TRAIN)
+    {
+        auto&& som_dimension = som.get_som_dimension();
+        auto&& neuron_dimension = som.get_neuron_dimension();
 
-    std::ifstream ifs(input_data.data_filename);
-    if (!ifs) throw std::runtime_error("Error opening " + input_data.data_filename);
+        // The SOM must be restored before the construction of the trainer, which copies it to the GPU
+        Checkpoint<T> resume_point;
+        if (!input_data.resume_filename.empty()) {
+            std::cout << "  Resume from checkpoint " << input_data.resume_filename << std::endl;
+            resume_point = read_checkpoint<T>(input_data.resume_filename);
 
-    auto&& iter_data_cur = DataIterator<DataLayout, T>(ifs);
-    auto&& iter_data_end = DataIterator<DataLayout, T>(ifs, true);
+            if (resume_point.number_of_entries != static_cast<uint32_t>(iter_data_cur.get_number_of_entries()) or
+                resume_point.seed != input_data.seed or
+                resume_point.shuffle_block_size != input_data.shuffle_block_size or
+                resume_point.shuffle_buffer_size != input_data.shuffle_buffer_size)
+                throw pink::exception("Checkpoint does not match the data file, seed or shuffle parameters.");
+            if (resume_point.som_dimension != std::vector<uint32_t>(std::begin(som_dimension), std::end(som_dimension)) or
+                resume_point.neuron_dimension != std::vector<uint32_t>(std::begin(neuron_dimension), std::end(neuron_dimension)) or
+                resume_point.som_data.size() != som.get_number_of_neurons() * som.get_neuron_size())
+                throw pink::exception("Checkpoint does not match the SOM dimensions.");
+
+            std::copy(std::begin(resume_point.som_data), std::end(resume_point.som_data), som.get_data_pointer());
+        }
 
-    if (input_data.executionPath == ExecutionPath::TRAIN)
-    {
         Trainer<SOMLayout, DataLayout, T, UseGPU> trainer(
             som
             ,input_data.get_distribution_function()
@@ -52,39 +90,138 @@ void main_generic(InputData const& input_data)
 #ifdef __CUDACC__
             ,input_data.block_size_1
             ,input_data.euclidean_distance_type
+#else
+            ,input_data.euclidean_distance_backend
+            ,input_data.coarse_rotation_step
+            ,input_data.number_of_refinement_candidates
 #endif
         );
 
+        if (!input_data.resume_filename.empty()) trainer.set_update_info(resume_point.update_info);
+
+        // Images collected for batch training, data views are not copied
+        std::vector<typename std::decay<decltype(*iter_data_cur)>::type> batch;
+        auto&& train_batch = [&]() {
+            if (batch.empty()) return;
+            trainer(batch);
+            batch.clear();
+        };
+
         ProgressBar progress_bar(iter_data_cur.get_number_of_entries() * input_data.numIter, 70, input_data.number_of_progress_prints);
-        uint32_t count = 0;
-        for (int i = 0; i < input_data.numIter; ++i)
+        uint32_t count = resume_point.intermediate_storage_count;
+        auto&& write_intermediate_som = [&]() {
+            std::string interStore_filename = input_data.result_filename;
+            if (input_data.intermediate_storage == IntermediateStorageType::KEEP) {
+                interStore_filename.insert(interStore_filename.find_last_of("."), "_" + std::to_string(count++));
+            }
+            if (input_data.verbose) std::cout << "  Write intermediate SOM to " << interStore_filename << " ... " << std::flush;
+            ScopedPhaseTimer timer(Phase::OUTPUT);
+            #ifdef __CUDACC__
+                trainer.update_som();
+            #endif
+            write(som, interStore_filename);
+            if (input_data.verbose) std::cout << "done." << std::endl;
+        };
+
+        // The snapshot is copied and written in the background
+        std::unique_ptr<CheckpointWriter<T>> checkpoint_writer;
+        if (!input_data.checkpoint_filename.empty()) checkpoint_writer.reset(new CheckpointWriter<T>(input_data.checkpoint_filename));
+
+        int iteration = resume_point.iteration;
+        uint32_t position = resume_point.position;
+        auto&& write_checkpoint = [&]() {
+            if (!checkpoint_writer) return;
+            ScopedPhaseTimer timer(Phase::OUTPUT);
+            #ifdef __CUDACC__
+                trainer.update_som();
+            #endif
+            Checkpoint<T> snapshot;
+            snapshot.iteration = iteration;
+            snapshot.position = position;
+            snapshot.number_of_entries = iter_data_cur.get_number_of_entries();
+            snapshot.seed = input_data.seed;
+            snapshot.shuffle_block_size = input_data.shuffle_block_size;
+            snapshot.shuffle_buffer_size = input_data.shuffle_buffer_size;
+            snapshot.intermediate_storage_count = count;
+            snapshot.som_dimension.assign(std::begin(som_dimension), std::end(som_dimension));
+            snapshot.neuron_dimension.assign(std::begin(neuron_dimension), std::end(neuron_dimension));
+            snapshot.som_data.assign(som.get_data_pointer(), som.get_data_pointer() + som.get_number_of_neurons() * som.get_neuron_size());
+            auto&& update_info = trainer.get_update_info();
+            snapshot.update_info.assign(update_info.get_data_pointer(), update_info.get_data_pointer() + update_info.size());
+            checkpoint_writer->write(std::move(snapshot));
+        };
+
+        // Called after each processed data entry
+        auto&& step = [&]() {
+            ++position;
+            ++processed_entries;
+            ++progress_bar;
+            if (!progress_bar.valid()) return;
+            if (input_data.intermediate_storage != IntermediateStorageType::OFF or checkpoint_writer) {
+                train_batch();
+                if (input_data.intermediate_storage != IntermediateStorageType::OFF) write_intermediate_som();
+                write_checkpoint();
+            }
+            write_metrics("progress");
+        };
+
+        progress_bar.set_ticks(iteration * iter_data_cur.get_number_of_entries() + position);
+
+        for (; iteration < input_data.numIter; ++iteration, position = 0)
         {
-            iter_data_cur.set_to_begin();
-            for (; iter_data_cur != iter_data_end; ++iter_data_cur, ++progress_bar)
+            iter_data_cur.set_to_position(position);
+
+            if (input_data.hogwild) {
+                // The step function is called in a critical section
+                trainer.train_hogwild(iter_data_cur, iter_data_end, [&]() {
+                    ++processed_entries;
+                    ++progress_bar;
+                    if (progress_bar.valid()) write_metrics("progress");
+                });
+                continue;
+            }
+
+            if (input_data.prefetch_size > 0) {
+                // Reading and rotation of the next images overlap with the training
+                typedef PrefetchPipeline<Iterator, std::vector<T>> PipelineType;
+                PipelineType pipeline(iter_data_cur, iter_data_end, input_data.prefetch_size,
+                    [&](typename PipelineType::DataPointType const& data) { return trainer.transform(data); },
+                    std::max(1, omp_get_max_threads() / 2));
+
+                typename PipelineType::Item item;
+                for (; pipeline.pop(item);)
+                {
+                    trainer(item.data, item.transformed);
+                    step();
+                }
+                continue;
+            }
+
+            for (; iter_data_cur != iter_data_end; ++iter_data_cur)
             {
-                trainer(*iter_data_cur);
-
-                if (progress_bar.valid() and input_data.intermediate_storage != IntermediateStorageType::OFF) {
-                    std::string interStore_filename = input_data.result_filename;
-                    if (input_data.intermediate_storage == IntermediateStorageType::KEEP) {
-                        interStore_filename.insert(interStore_filename.find_last_of("."), "_" + std::to_string(count++));
-                    }
-                    if (input_data.verbose) std::cout << "  Write intermediate SOM to " << interStore_filename << " ... " << std::flush;
-                    #ifdef __CUDACC__
-                        trainer.update_som();
-                    #endif
-                    write(som, interStore_filename);
-                    if (input_data.verbose) std::cout << "done." << std::endl;
+                if (input_data.batch_size > 1) {
+                    batch.push_back(*iter_data_cur);
+                    if (batch.size() == input_data.batch_size) train_batch();
+                } else {
+                    trainer(*iter_data_cur);
                 }
+                step();
             }
+            train_batch();
         }
 
+        if (checkpoint_writer) checkpoint_writer->wait();
+
         std::cout << "  Write final SOM to " << input_data.result_filename << " ... " << std::flush;
+        {
+            ScopedPhaseTimer timer(Phase::OUTPUT);
 #ifdef __CUDACC__
-        trainer.update_som();
+            trainer.update_som();
 #endif
-        write(som, input_data.result_filename);
+            write(som, input_data.result_filename);
+        }
         std::cout << "done." << std::endl;
+        write_metrics("final");
 
         if (input_data.verbose) {
             std::cout << "\n  Number of updates of each neuron:\n\n"
@@ -95,45 +232,48 @@ void main_generic(InputData const& input_data)
     else if (input_data.executionPath == ExecutionPath::MAP)
     {
         // File for euclidean distances
-        std::ofstream result_file(input_data.result_filename);
-        if (!result_file) throw pink::exception("Error opening " + input_data.result_filename);
+        BufferedWriter result_file(input_data.result_filename, input_data.write_buffer_size,
+            input_data.write_async, input_data.direct_io);
 
         // <file format version> 2 <data-type> <number of entries> <som layout> <data>
+        // or for the k best matches
+        // <file format version> 5 <data-type> <number of entries> <som layout> <k> <data>
         int version = 2;
-        int file_type = 2;
+        int file_type = input_data.top_k > 0 ? 5 : 2;
         int data_type_idx = 0;
         int som_layout_idx = 0;
         int som_dimensionality = som.get_som_layout().dimensionality;
         int number_of_data_entries = iter_data_cur.get_number_of_entries();
 
-        result_file.write((char*)&version, sizeof(int));
-        result_file.write((char*)&file_type, sizeof(int));
-        result_file.write((char*)&data_type_idx, sizeof(int));
-        result_file.write((char*)&number_of_data_entries, sizeof(int));
-        result_file.write((char*)&som_layout_idx, sizeof(int));
-        result_file.write((char*)&som_dimensionality, sizeof(int));
+        result_file.write(version);
+        result_file.write(file_type);
+        result_file.write(data_type_idx);
+        result_file.write(number_of_data_entries);
+        result_file.write(som_layout_idx);
+        result_file.write(som_dimensionality);
         for (int dim = 0; dim != som_dimensionality; ++dim) {
             int tmp = som.get_som_layout().dimension[dim];
-            result_file.write((char*)&tmp, sizeof(int));
+            result_file.write(tmp);
         }
+        if (input_data.top_k > 0) result_file.write(input_data.top_k);
 
         // File for spatial_transformations (optional)
-        std::ofstream spatial_transformation_file;
+        std::unique_ptr<BufferedWriter> spatial_transformation_file;
         if (input_data.write_rot_flip) {
-            spatial_transformation_file.open(input_data.rot_flip_filename);
-            if (!spatial_transformation_file) throw pink::exception("Error opening " + input_data.rot_flip_filename);
+            spatial_transformation_file.reset(new BufferedWriter(input_data.rot_flip_filename,
+                input_data.write_buffer_size, input_data.write_async, input_data.direct_io));
 
             // <file format version> 3 <number of entries> <som layout> <data>
             int file_type = 3;
 
-            spatial_transformation_file.write((char*)&version, sizeof(int));
-            spatial_transformation_file.write((char*)&file_type, sizeof(int));
-            spatial_transformation_file.write((char*)&number_of_data_entries, sizeof(int));
-            spatial_transformation_file.write((char*)&som_layout_idx, sizeof(int));
-            spatial_transformation_file.write((char*)&som_dimensionality, sizeof(int));
+            spatial_transformation_file->write(version);
+            spatial_transformation_file->write(file_type);
+            spatial_transformation_file->write(number_of_data_entries);
+            spatial_transformation_file->write(som_layout_idx);
+            spatial_transformation_file->write(som_dimensionality);
             for (int dim = 0; dim != som_dimensionality; ++dim) {
                 int tmp = som.get_som_layout().dimension[dim];
-                spatial_transformation_file.write((char*)&tmp, sizeof(int));
+                spatial_transformation_file->write(tmp);
             }
         }
 
@@ -147,28 +287,103 @@ void main_generic(InputData const& input_data)
 #ifdef __CUDACC__
             ,input_data.block_size_1
             ,input_data.euclidean_distance_type
+#else
+            ,input_data.euclidean_distance_backend
+            ,input_data.coarse_rotation_step
+            ,input_data.number_of_refinement_candidates
 #endif
         );
 
-        ProgressBar progress_bar(iter_data_cur.get_number_of_entries(), 70, input_data.number_of_progress_prints);
-        for (; iter_data_cur != iter_data_end; ++iter_data_cur, ++progress_bar)
-        {
-            auto result = mapper(*iter_data_cur);
+        std::vector<char> top_k_record(input_data.top_k * 13);
+        std::vector<char> rot_flip_record(som.get_number_of_neurons() * (sizeof(char) + sizeof(float)));
+        auto&& write_result = [&](auto const& result) {
             // corresponds to structured binding with C++17:
             //auto& [euclidean_distance_matrix, best_rotation_matrix] = mapper(data);
 
-            result_file.write((char*)&std::get<0>(result)[0], som.get_number_of_neurons() * sizeof(float));
+            if (input_data.top_k > 0) {
+                auto&& best_matches = mapper.get_best_matches(result, input_data.top_k);
+
+                // Packed records of the neuron (int), the distance (float), the flip (char), and the angle (float)
+                ScopedPhaseTimer timer(Phase::OUTPUT);
+                char *p = &top_k_record[0];
+                for (auto&& best_match : best_matches) {
+                    char flip = best_match.flip;
+                    std::memcpy(p, &best_match.neuron, sizeof(uint32_t));
+                    std::memcpy(p + 4, &best_match.euclidean_distance, sizeof(float));
+                    std::memcpy(p + 8, &flip, sizeof(char));
+                    std::memcpy(p + 9, &best_match.angle, sizeof(float));
+                    p += 13;
+                }
+                result_file.write(&top_k_record[0], p - &top_k_record[0]);
+            } else {
+                ScopedPhaseTimer timer(Phase::OUTPUT);
+                result_file.write(&std::get<0>(result)[0], som.get_number_of_neurons() * sizeof(float));
+            }
 
             if (input_data.write_rot_flip) {
-                float angle_step_radians = 0.5 * M_PI / input_data.number_of_rotations / 4;
+                // Packed records of the flip (char) and the angle (float) are written at once
+                ScopedPhaseTimer timer(Phase::OUTPUT);
+                char *p = &rot_flip_record[0];
                 for (uint32_t i = 0; i != som.get_number_of_neurons(); ++i) {
-                    char flip = std::get<1>(result)[i] / input_data.number_of_rotations;
-                    float angle = (std::get<1>(result)[i] % input_data.number_of_rotations) * angle_step_radians;
-                    spatial_transformation_file.write(&flip, sizeof(char));
-                    spatial_transformation_file.write((char*)&angle, sizeof(float));
+                    char flip = mapper.get_flip(std::get<1>(result)[i]);
+                    float angle = mapper.get_angle(std::get<1>(result)[i]);
+                    *p++ = flip;
+                    std::memcpy(p, &angle, sizeof(float));
+                    p += sizeof(float);
                 }
+                spatial_transformation_file->write(&rot_flip_record[0], rot_flip_record.size());
+            }
+        };
+
+        ProgressBar progress_bar(iter_data_cur.get_number_of_entries(), 70, input_data.number_of_progress_prints);
+        auto&& step = [&]() {
+            ++processed_entries;
+            ++progress_bar;
+            if (progress_bar.valid()) write_metrics("progress");
+        };
+
+        // The results of single data points are reused for the next one
+        std::vector<T> euclidean_distance_matrix;
+        std::vector<uint32_t> best_rotation_matrix;
+        auto&& result = std::tie(euclidean_distance_matrix, best_rotation_matrix);
+
+        if (input_data.prefetch_size > 0) {
+            // Reading and rotation of the next images overlap with the mapping
+            typedef PrefetchPipeline<Iterator, std::vector<T>> PipelineType;
+            PipelineType pipeline(iter_data_cur, iter_data_end, input_data.prefetch_size,
+                [&](typename PipelineType::DataPointType const& data) { return mapper.transform(data); },
+                std::max(1, omp_get_max_threads() / 2));
+
+            typename PipelineType::Item item;
+            for (; pipeline.pop(item); step()) {
+                mapper(item.data, item.transformed, euclidean_distance_matrix, best_rotation_matrix);
+                write_result(result);
+            }
+        } else if (input_data.batch_size > 1) {
+            // The images of a batch are mapped in parallel, data views are not copied
+            std::vector<typename std::decay<decltype(*iter_data_cur)>::type> batch;
+            auto&& map_batch = [&]() {
+                for (auto&& result : mapper.map_batch(batch)) write_result(result);
+                batch.clear();
+            };
+            for (; iter_data_cur != iter_data_end; ++iter_data_cur, step()) {
+                batch.push_back(*iter_data_cur);
+                if (batch.size() == input_data.batch_size) map_batch();
+            }
+            map_batch();
+        } else {
+            for (; iter_data_cur != iter_data_end; ++iter_data_cur, step()) {
+                mapper(*iter_data_cur, euclidean_distance_matrix, best_rotation_matrix);
+                write_result(result);
             }
         }
+
+        {
+            ScopedPhaseTimer timer(Phase::OUTPUT);
+            result_file.close();
+            if (spatial_transformation_file) spatial_transformation_file->close();
+        }
+        write_metrics("final");
     }
     else
     {
@@ -176,4 +391,36 @@ void main_generic(InputData const& input_data)
     }
 }
 
+template <typename SOMLayout, typename DataLayout, typename T, bool UseGPU>
+void main_generic(InputData const& input_data)
+{
+    if (input_data.verbose)
+        std::cout << "SOM layout:  " << SOMLayout::type  << "<" << static_cast<int>(SOMLayout::dimensionality)  << ">" << "\n"
+                  << "Data layout: " << DataLayout::type << "<" << static_cast<int>(DataLayout::dimensionality) << ">" << "\n"
+                  << std::endl;
+
+    set_use_huge_pages(input_data.use_huge_pages);
+
+    SOM<SOMLayout, DataLayout, T> som(input_data);
+
+    if (input_data.use_mmap) {
+        if (MmapDataIterator<DataLayout, T>::is_applicable(input_data.data_filename)) {
+            auto&& iter_data_cur = MmapDataIterator<DataLayout, T>(input_data.data_filename, input_data.seed,
+                input_data.shuffle_block_size, input_data.shuffle_buffer_size);
+            auto&& iter_data_end = MmapDataIterator<DataLayout, T>(input_data.data_filename, true);
+            main_generic<SOMLayout, DataLayout, T, UseGPU>(input_data, som, iter_data_cur, iter_data_end);
+            return;
+        }
+        if (input_data.verbose) std::cout << "  Data file can not be memory mapped, memory mapping is switched off." << std::endl;
+    }
+
+    std::ifstream ifs(input_data.data_filename);
+    if (!ifs) throw std::runtime_error("Error opening " + input_data.data_filename);
+
+    auto&& iter_data_cur = DataIterator<DataLayout, T>(ifs, input_data.seed,
+        input_data.shuffle_block_size, input_data.shuffle_buffer_size);
+    auto&& iter_data_end = DataIterator<DataLayout, T>(ifs, true);
+    main_generic<SOMLayout, DataLayout, T, UseGPU>(input_data, som, iter_data_cur, iter_data_end);
+}
+
 } // namespace pink
@@ -4,6 +4,7 @@
  * @author Bernd Doser, HITS gGmbH
  */
 
+#include <algorithm>
 #include <pybind11/functional.h>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
@@ -11,7 +12,10 @@
 #include "SelfOrganizingMapLib/Mapper.h"
 #include "SelfOrganizingMapLib/Trainer.h"
 #include "SelfOrganizingMapLib/Data.h"
+#include "SelfOrganizingMapLib/DataView.h"
 #include "SelfOrganizingMapLib/SOM.h"
+#include "UtilitiesLib/AlignedAllocator.h"
+#include "UtilitiesLib/EuclideanDistanceBackend.h"
 #include "UtilitiesLib/Interpolation.h"
 #include "UtilitiesLib/Version.h"
 
@@ -66,7 +70,10 @@ PYBIND11_MODULE(pink, m)
             auto&& dim1 = static_cast<uint32_t>(info.shape[1]);
             auto&& dim2 = static_cast<uint32_t>(info.shape[2]);
             auto&& dim3 = static_cast<uint32_t>(info.shape[3]);
-            return new SOM<CartesianLayout<2>, CartesianLayout<2>, float>({dim0, dim1}, {dim2, dim3}, std::vector<float>(p, p + dim0 * dim1 * dim2 * dim3));
+            // The buffer is copied once into the aligned storage, which is moved into the SOM
+            AlignedVector<float> data(dim0 * dim1 * dim2 * dim3);
+            first_touch(data.data(), p, data.size());
+            return new SOM<CartesianLayout<2>, CartesianLayout<2>, float>({dim0, dim1}, {dim2, dim3}, std::move(data));
         }))
         .def_buffer([](SOM<CartesianLayout<2>, CartesianLayout<2>, float> &m) -> py::buffer_info {
 
@@ -94,8 +101,14 @@ PYBIND11_MODULE(pink, m)
        .value("BILINEAR", Interpolation::BILINEAR)
        .export_values();
 
+    py::enum_<EuclideanDistanceBackend>(m, "euclidean_distance_backend")
+       .value("DIRECT", EuclideanDistanceBackend::DIRECT)
+       .value("GEMM", EuclideanDistanceBackend::GEMM)
+       .export_values();
+
     py::class_<Trainer<CartesianLayout<2>, CartesianLayout<2>, float, false>>(m, "trainer_cpu")
-        .def(py::init<SOM<CartesianLayout<2>, CartesianLayout<2>, float>&, std::function<float(float)>, int, uint32_t, bool, float, Interpolation, int>(),
+        .def(py::init<SOM<CartesianLayout<2>, CartesianLayout<2>, float>&, std::function<float(float)>, int, uint32_t, bool, float,
+            Interpolation, int, EuclideanDistanceBackend, uint32_t, uint32_t>(),
             py::arg("som"),
             py::arg("distribution_function"),
             py::arg("verbosity") = 0,
@@ -103,26 +116,74 @@ PYBIND11_MODULE(pink, m)
             py::arg("use_flip") = true,
             py::arg("max_update_distance") = -1.0,
             py::arg("interpolation") = Interpolation::BILINEAR,
-            py::arg("euclidean_distance_dim") = -1
+            py::arg("euclidean_distance_dim") = -1,
+            py::arg("euclidean_distance_backend") = EuclideanDistanceBackend::DIRECT,
+            py::arg("coarse_rotation_step") = 1,
+            py::arg("number_of_refinement_candidates") = 2
         )
         .def("__call__", [](Trainer<CartesianLayout<2>, CartesianLayout<2>, float, false>& trainer, Data<CartesianLayout<2>, float> const& data)
         {
             return trainer(data);
         });
 
-    py::class_<Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false>>(m, "mapper_cpu")
-        .def(py::init<SOM<CartesianLayout<2>, CartesianLayout<2>, float>&, int, uint32_t, bool, Interpolation, int>(),
+    py::class_<Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false>>(m, "mapper_cpu",
+        "Maps images to a snapshot of the SOM taken at construction. "
+        "Call update_som() after the SOM was changed, e.g. by trainer_cpu or by writing into its buffer.")
+        .def(py::init<SOM<CartesianLayout<2>, CartesianLayout<2>, float>&, int, uint32_t, bool, Interpolation, int,
+            EuclideanDistanceBackend, uint32_t, uint32_t>(),
             py::arg("som"),
             py::arg("verbosity") = 0,
             py::arg("number_of_rotations") = 360,
             py::arg("use_flip") = true,
             py::arg("interpolation") = Interpolation::BILINEAR,
-            py::arg("euclidean_distance_dim") = -1
+            py::arg("euclidean_distance_dim") = -1,
+            py::arg("euclidean_distance_backend") = EuclideanDistanceBackend::DIRECT,
+            py::arg("coarse_rotation_step") = 1,
+            py::arg("number_of_refinement_candidates") = 2
         )
         .def("__call__", [](Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false>& mapper, Data<CartesianLayout<2>, float> const& data)
         {
             return mapper(data);
-        });
+        })
+        .def("map_batch", [](Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false>& mapper,
+            py::array_t<float, py::array::c_style | py::array::forcecast> images)
+        {
+            py::buffer_info info = images.request();
+
+            if (info.ndim != 3) throw std::runtime_error("Incompatible buffer dimension!");
+
+            auto&& p = static_cast<float const*>(info.ptr);
+            auto&& number_of_images = static_cast<size_t>(info.shape[0]);
+            auto&& dim0 = static_cast<uint32_t>(info.shape[1]);
+            auto&& dim1 = static_cast<uint32_t>(info.shape[2]);
+
+            // The images are not copied
+            std::vector<DataView<CartesianLayout<2>, float>> batch;
+            batch.reserve(number_of_images);
+            for (size_t i = 0; i != number_of_images; ++i) {
+                batch.emplace_back(CartesianLayout<2>{{dim0, dim1}}, p + i * dim0 * dim1);
+            }
+
+            // The GIL is kept, so that calls on the same mapper are serialized and the SOM and the
+            // images cannot be modified through the buffer protocol while they are mapped.
+            // The images are still distributed over the OpenMP threads.
+            auto&& results = mapper.map_batch(batch);
+
+            size_t number_of_neurons = results.empty() ? 0 : std::get<0>(results[0]).size();
+            py::array_t<float> euclidean_distances({number_of_images, number_of_neurons});
+            py::array_t<uint32_t> best_rotations({number_of_images, number_of_neurons});
+            for (size_t i = 0; i != number_of_images; ++i) {
+                std::copy(std::get<0>(results[i]).begin(), std::get<0>(results[i]).end(),
+                    euclidean_distances.mutable_data(i));
+                std::copy(std::get<1>(results[i]).begin(), std::get<1>(results[i]).end(),
+                    best_rotations.mutable_data(i));
+            }
+            return py::make_tuple(euclidean_distances, best_rotations);
+        }, py::arg("images"))
+        .def("update_som", [](Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false>& mapper)
+        {
+            mapper.update_som();
+        }, "Takes a new snapshot of the SOM");
 
 #ifdef __CUDACC__
 
@@ -0,0 +1,201 @@
+/**
+ * @file   SelfOrganizingMapLib/Checkpoint.h
+ * @brief  Complete state of a training run for resuming.
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "UtilitiesLib/FileDataType.h"
+#include "UtilitiesLib/pink_exception.h"
+
+namespace pink {
+
+/// Snapshot of the training: SOM, number of updates of each neuron, and the position of the
+/// data iterator. The order of the data entries is reproduced by the seed and the shuffle parameters.
+template <typename T>
+struct Checkpoint
+{
+    /// Current iteration over all data entries
+    uint32_t iteration = 0;
+
+    /// Number of processed data entries of the current iteration
+    uint32_t position = 0;
+
+    uint32_t number_of_entries = 0;
+
+    int seed = 0;
+
+    uint32_t shuffle_block_size = 0;
+
+    uint32_t shuffle_buffer_size = 0;
+
+    /// Counter of the intermediate SOM files
+    uint32_t intermediate_storage_count = 0;
+
+    std::vector<uint32_t> som_dimension;
+
+    std::vector<uint32_t> neuron_dimension;
+
+    std::vector<T> som_data;
+
+    /// Number of updates of each neuron
+    std::vector<uint32_t> update_info;
+};
+
+namespace checkpoint_io {
+
+template <typename V>
+void write_value(std::ostream& os, V const& value)
+{
+    os.write(reinterpret_cast<char const*>(&value), sizeof(V));
+}
+
+template <typename V>
+void write_vector(std::ostream& os, std::vector<V> const& v)
+{
+    write_value(os, static_cast<uint32_t>(v.size()));
+    os.write(reinterpret_cast<char const*>(v.data()), v.size() * sizeof(V));
+}
+
+template <typename V>
+void read_value(std::istream& is, V& value)
+{
+    is.read(reinterpret_cast<char*>(&value), sizeof(V));
+}
+
+template <typename V>
+void read_vector(std::istream& is, std::vector<V>& v)
+{
+    uint32_t size = 0;
+    read_value(is, size);
+    v.resize(size);
+    is.read(reinterpret_cast<char*>(v.data()), v.size() * sizeof(V));
+}
+
+} // namespace checkpoint_io
+
+/// Writes the checkpoint to a temporary file, which replaces the file at the end.
+/// Therefore, a crash during writing does not destroy the previous checkpoint.
+template <typename T>
+void write(Checkpoint<T> const& checkpoint, std::string const& filename)
+{
+    static_assert(std::is_same<T, float>::value, "Checkpoints are only supported for float");
+    using namespace checkpoint_io;
+
+    std::string tmp_filename = filename + ".tmp";
+    {
+        std::ofstream os(tmp_filename, std::ios::binary);
+        if (!os) throw pink::exception("Error opening " + tmp_filename);
+
+        // <file format version> 6 <data-type> <state> <SOM dimension> <neuron dimension> <SOM data> <updates>
+        write_value(os, 2);
+        write_value(os, 6);
+        write_value(os, static_cast<int>(FileDataType::FLOAT32));
+        write_value(os, checkpoint.iteration);
+        write_value(os, checkpoint.position);
+        write_value(os, checkpoint.number_of_entries);
+        write_value(os, checkpoint.seed);
+        write_value(os, checkpoint.shuffle_block_size);
+        write_value(os, checkpoint.shuffle_buffer_size);
+        write_value(os, checkpoint.intermediate_storage_count);
+        write_vector(os, checkpoint.som_dimension);
+        write_vector(os, checkpoint.neuron_dimension);
+        write_vector(os, checkpoint.som_data);
+        write_vector(os, checkpoint.update_info);
+
+        os.flush();
+        if (!os) throw pink::exception("Error writing " + tmp_filename);
+    }
+
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+        throw pink::exception("Error renaming " + tmp_filename + " to " + filename);
+}
+
+template <typename T>
+Checkpoint<T> read_checkpoint(std::string const& filename)
+{
+    static_assert(std::is_same<T, float>::value, "Checkpoints are only supported for float");
+    using namespace checkpoint_io;
+
+    std::ifstream is(filename, std::ios::binary);
+    if (!is) throw pink::exception("Error opening " + filename);
+
+    int version = 0, file_type = 0, data_type = 0;
+    read_value(is, version);
+    read_value(is, file_type);
+    read_value(is, data_type);
+    if (version != 2 or file_type != 6) throw pink::exception(filename + " is not a checkpoint file.");
+    if (data_type != static_cast<int>(FileDataType::FLOAT32))
+        throw pink::exception("Data type " + std::to_string(data_type) + " of checkpoint file " + filename + " is not float32.");
+
+    Checkpoint<T> checkpoint;
+    read_value(is, checkpoint.iteration);
+    read_value(is, checkpoint.position);
+    read_value(is, checkpoint.number_of_entries);
+    read_value(is, checkpoint.seed);
+    read_value(is, checkpoint.shuffle_block_size);
+    read_value(is, checkpoint.shuffle_buffer_size);
+    read_value(is, checkpoint.intermediate_storage_count);
+    read_vector(is, checkpoint.som_dimension);
+    read_vector(is, checkpoint.neuron_dimension);
+    read_vector(is, checkpoint.som_data);
+    read_vector(is, checkpoint.update_info);
+
+    if (!is) throw pink::exception("Checkpoint file " + filename + " is truncated.");
+    return checkpoint;
+}
+
+/// Writes checkpoints in the background. The snapshot is taken by the caller, so that the
+/// training can continue while the file is written. Errors are rethrown by the next call.
+template <typename T>
+class CheckpointWriter
+{
+public:
+
+    explicit CheckpointWriter(std::string const& filename)
+     : filename(filename)
+    {}
+
+    ~CheckpointWriter()
+    {
+        try {
+            wait();
+        } catch (...) {}
+    }
+
+    CheckpointWriter(CheckpointWriter const&) = delete;
+    CheckpointWriter& operator = (CheckpointWriter const&) = delete;
+
+    /// Waits for the previous checkpoint and starts writing the snapshot
+    void write(Checkpoint<T>&& snapshot)
+    {
+        wait();
+        pending_write = std::async(std::launch::async,
+            [this](Checkpoint<T> const& checkpoint){ pink::write(checkpoint, filename); }, std::move(snapshot));
+    }
+
+    /// Waits until the last checkpoint is written
+    void wait()
+    {
+        if (pending_write.valid()) pending_write.get();
+    }
+
+private:
+
+    std::string filename;
+
+    std::future<void> pending_write;
+};
+
+} // namespace pink
@@ -0,0 +1,122 @@
+/**
+ * @file   SelfOrganizingMapLib/ChunkedDataWriter.h
+ * @brief  Writer of data files with independently compressed chunks of entries.
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "UtilitiesLib/FileDataType.h"
+#include "UtilitiesLib/LZ4.h"
+#include "UtilitiesLib/pink_exception.h"
+
+namespace pink {
+
+/// Writes a chunked data file (file type 4 in FILE_FORMATS.md). The binary header is written
+/// at construction, the chunk offsets are filled in by close(), so the stream must be seekable.
+class ChunkedDataWriter
+{
+public:
+
+    ChunkedDataWriter(std::ostream& os, FileDataType data_type, uint32_t number_of_entries,
+        std::vector<uint32_t> const& dimension, uint32_t entries_per_chunk, int layout = 0)
+     : os(os),
+       entry_size(get_size(data_type)),
+       number_of_entries(number_of_entries),
+       entries_per_chunk(entries_per_chunk),
+       number_of_written_entries(0),
+       closed(false)
+    {
+        if (entries_per_chunk == 0) throw pink::exception("ChunkedDataWriter: entries per chunk must be > 0");
+        for (auto&& d : dimension) entry_size *= d;
+
+        uint32_t number_of_chunks = (number_of_entries + entries_per_chunk - 1) / entries_per_chunk;
+        std::vector<int> header{2, 4, static_cast<int>(data_type), static_cast<int>(number_of_entries),
+            layout, static_cast<int>(dimension.size())};
+        for (auto&& d : dimension) header.push_back(d);
+        header.push_back(entries_per_chunk);
+        header.push_back(number_of_chunks);
+        os.write(reinterpret_cast<char const*>(&header[0]), header.size() * sizeof(int));
+
+        index_position = os.tellp();
+        offsets.reserve(number_of_chunks + 1);
+        offsets.push_back(0);
+        std::vector<uint64_t> placeholder(number_of_chunks + 1, 0);
+        os.write(reinterpret_cast<char const*>(&placeholder[0]), placeholder.size() * sizeof(uint64_t));
+    }
+
+    ~ChunkedDataWriter()
+    {
+        try {
+            close();
+        } catch (...) {}
+    }
+
+    ChunkedDataWriter(ChunkedDataWriter const&) = delete;
+    ChunkedDataWriter& operator = (ChunkedDataWriter const&) = delete;
+
+    /// Appends an entry stored in the data type of the file
+    void write(char const *entry)
+    {
+        if (number_of_written_entries == number_of_entries)
+            throw pink::exception("ChunkedDataWriter: too many entries");
+        chunk.insert(chunk.end(), entry, entry + entry_size);
+        ++number_of_written_entries;
+        if (chunk.size() == entries_per_chunk * entry_size) write_chunk();
+    }
+
+    /// Writes the last chunk and the chunk offsets
+    void close()
+    {
+        if (closed) return;
+        closed = true;
+
+        if (number_of_written_entries != number_of_entries)
+            throw pink::exception("ChunkedDataWriter: number of entries does not match");
+        if (!chunk.empty()) write_chunk();
+
+        auto&& end_position = os.tellp();
+        os.seekp(index_position);
+        os.write(reinterpret_cast<char const*>(&offsets[0]), offsets.size() * sizeof(uint64_t));
+        os.seekp(end_position);
+    }
+
+private:
+
+    void write_chunk()
+    {
+        auto&& compressed = lz4_compress(chunk.data(), chunk.size());
+        os.write(compressed.data(), compressed.size());
+        offsets.push_back(offsets.back() + compressed.size());
+        chunk.clear();
+    }
+
+    std::ostream& os;
+
+    /// Size of an entry in bytes
+    size_t entry_size;
+
+    uint32_t number_of_entries;
+
+    uint32_t entries_per_chunk;
+
+    uint32_t number_of_written_entries;
+
+    /// Position of the chunk offsets in the stream
+    std::streampos index_position;
+
+    /// Positions of the chunks relative to the first one, the last element is the end of the last chunk
+    std::vector<uint64_t> offsets;
+
+    /// Uncompressed entries of the current chunk
+    std::vector<char> chunk;
+
+    bool closed;
+};
+
+} // namespace pink
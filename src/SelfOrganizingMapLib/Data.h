@@ -9,10 +9,14 @@
 #include <array>
 #include <cstddef>
 #include <functional>
+#include <utility>
 #include <vector>
 
 namespace pink {
 
+template <typename Layout, typename T>
+class DataView;
+
 /// Primary template for generic Data
 template <typename Layout, typename T>
 class Data
@@ -50,7 +54,13 @@ public:
     /// Construction and move data
     Data(LayoutType const& layout, std::vector<T>&& data)
      : layout(layout),
-       data(data)
+       data(std::move(data))
+    {}
+
+    /// Construction and copy data of a view
+    explicit Data(DataView<Layout, T> const& view)
+     : layout(view.get_layout()),
+       data(view.get_data_pointer(), view.get_data_pointer() + view.size())
     {}
 
     /// Copy construction
@@ -68,8 +78,9 @@ public:
 
     auto size() const { return data.size(); }
 
-    auto get_data() { return data; }
-    auto get_data() const { return data; }
+    /// Returns the elements without copy, the elements of a temporary are moved
+    auto get_data() const & -> std::vector<T> const& { return data; }
+    auto get_data() && -> std::vector<T> { return std::move(data); }
 
     /// Return the element
     auto operator [] (uint32_t position) -> T& { return data[position]; }
@@ -9,12 +9,15 @@
 #include <algorithm>
 #include <istream>
 #include <memory>
-#include <numeric>
-#include <random>
 #include <string>
 #include <vector>
 
 #include "Data.h"
+#include "ShuffleOrder.h"
+#include "UtilitiesLib/FileDataType.h"
+#include "UtilitiesLib/LRUCache.h"
+#include "UtilitiesLib/LZ4.h"
+#include "UtilitiesLib/PhaseTimer.h"
 #include "UtilitiesLib/pink_exception.h"
 
 namespace pink {
@@ -28,22 +31,40 @@ public:
     typedef Data<Layout, T> DataType;
     typedef std::shared_ptr<DataType> PtrDataType;
 
+    /// Number of decompressed chunks kept in memory for chunked data files
+    static const size_t chunk_cache_size = 8;
+
     /// Default constructor
     DataIterator(std::istream& is, bool end_flag)
      : number_of_entries(0),
        is(is),
        header_offset(0),
+       data_type(FileDataType::FLOAT32),
        end_flag(end_flag),
-       seed(1234)
+       seed(1234),
+       entries_per_chunk(0),
+       chunk_cache(chunk_cache_size)
     {}
 
     /// Parameter constructor
-    DataIterator(std::istream& is, uint64_t seed = 1234)
+    ///
+    /// For a block_size larger than zero the entries are block-shuffled (see @get_block_shuffled_order)
+    /// and the entries of a buffer are read at once by sequential reads of the contiguous blocks.
+    /// Entries stored with a reduced precision (see @FileDataType) are converted to T.
+    /// The chunks of chunked data files are decompressed on demand and the last ones are cached,
+    /// therefore a block shuffle with a block size of the chunk size should be used for them.
+    DataIterator(std::istream& is, uint64_t seed = 1234, uint32_t block_size = 0, uint32_t buffer_size = 0)
      : number_of_entries(0),
        is(is),
        header_offset(0),
+       data_type(FileDataType::FLOAT32),
        end_flag(false),
-       seed(seed)
+       seed(seed),
+       block_size(block_size),
+       buffer_begin(0),
+       buffer_end(0),
+       entries_per_chunk(0),
+       chunk_cache(chunk_cache_size)
     {
         // Skip all header lines starting with #
         std::string line;
@@ -58,8 +79,13 @@ public:
         // Reset EOF flag
         is.clear();
 
-        // Ignore first three entries
-        is.seekg(binary_start_position + 3 * sizeof(int), is.beg);
+        // Ignore version
+        is.seekg(binary_start_position + sizeof(int), is.beg);
+        int file_type, data_type_code;
+        is.read((char*)&file_type, sizeof(int));
+        if (file_type != 0 and file_type != 4) throw pink::exception("DataIterator: file type is not a data file");
+        is.read((char*)&data_type_code, sizeof(int));
+        data_type = get_file_data_type(data_type_code);
         is.read((char*)&number_of_entries, sizeof(int));
         // Ignore layout and dimensionality
         is.seekg(2 * sizeof(int), is.cur);
@@ -68,14 +94,20 @@ public:
             is.read((char*)&layout.dimension[i], sizeof(int));
         }
 
-        header_offset = is.tellg();
+        // Chunked data file
+        if (file_type == 4) {
+            uint32_t number_of_chunks;
+            is.read((char*)&entries_per_chunk, sizeof(int));
+            is.read((char*)&number_of_chunks, sizeof(int));
+            if (entries_per_chunk == 0 or number_of_chunks != (number_of_entries + entries_per_chunk - 1) / entries_per_chunk)
+                throw pink::exception("DataIterator: invalid chunk index");
+            chunk_offsets.resize(number_of_chunks + 1);
+            is.read((char*)chunk_offsets.data(), chunk_offsets.size() * sizeof(uint64_t));
+        }
 
-        random_list.resize(number_of_entries);
-        std::iota(std::begin(random_list), std::end(random_list), 0);
+        header_offset = is.tellg();
 
-        std::default_random_engine engine(seed);
-        std::mt19937 dist(engine());
-        std::shuffle(std::begin(random_list), std::end(random_list), dist);
+        random_list = get_block_shuffled_order(number_of_entries, block_size, buffer_size, seed, buffer_ends);
 
         cur_random_list = std::begin(random_list);
 
@@ -112,8 +144,15 @@ public:
     /// Set to first position
     void set_to_begin()
     {
-        cur_random_list = std::begin(random_list);
+        set_to_position(0);
+    }
+
+    /// Set to the position in the order of the entries, used to resume an interrupted iteration
+    void set_to_position(uint32_t position)
+    {
+        cur_random_list = std::begin(random_list) + std::min(static_cast<size_t>(position), random_list.size());
         end_flag = false;
+        next();
     }
 
     /// Dereference
@@ -136,16 +175,90 @@ private:
     /// Read next entry
     void next()
     {
+        ScopedPhaseTimer timer(Phase::IO);
+
         if (cur_random_list != std::end(random_list)) {
-            is.seekg(header_offset + *cur_random_list * layout.size() * sizeof(T), is.beg);
-            ptr_current_entry = std::make_shared<DataType>(layout);
-            is.read((char*)ptr_current_entry->get_data_pointer(), layout.size() * sizeof(T));
+            // The entry is reused if it is not shared with a copy of the iterator
+            if (!ptr_current_entry or ptr_current_entry.use_count() > 1) ptr_current_entry = std::make_shared<DataType>(layout);
+            if (block_size == 0) {
+                read_entries(*cur_random_list, 1, ptr_current_entry->get_data_pointer());
+            } else {
+                size_t position = cur_random_list - std::begin(random_list);
+                if (position < buffer_begin or position >= buffer_end) read_buffer(position);
+                size_t slot = std::lower_bound(std::begin(buffer_entries), std::end(buffer_entries), *cur_random_list)
+                            - std::begin(buffer_entries);
+                std::copy_n(&buffer[slot * layout.size()], layout.size(), ptr_current_entry->get_data_pointer());
+            }
             ++cur_random_list;
         } else {
             end_flag = true;
         }
     }
 
+    /// Read all entries of the buffer containing the position by sequential reads of the contiguous ranges
+    void read_buffer(size_t position)
+    {
+        auto&& iter_buffer_end = std::upper_bound(std::begin(buffer_ends), std::end(buffer_ends), position);
+        buffer_end = *iter_buffer_end;
+        buffer_begin = iter_buffer_end == std::begin(buffer_ends) ? 0 : *(iter_buffer_end - 1);
+
+        buffer_entries.assign(std::begin(random_list) + buffer_begin, std::begin(random_list) + buffer_end);
+        std::sort(std::begin(buffer_entries), std::end(buffer_entries));
+
+        buffer.resize(buffer_entries.size() * layout.size());
+        T *p = buffer.data();
+        for (auto&& range : get_contiguous_ranges(buffer_entries)) {
+            read_entries(range.first, range.second, p);
+            p += range.second * layout.size();
+        }
+    }
+
+    /// Read contiguous entries, which are converted if the data type of the file is not T
+    void read_entries(uint32_t first, uint32_t count, T *p)
+    {
+        uint64_t entry_size = layout.size() * get_size(data_type);
+        if (entries_per_chunk != 0) {
+            for (uint32_t entry = first; entry != first + count;) {
+                uint32_t chunk = entry / entries_per_chunk;
+                uint32_t n = std::min(first + count, (chunk + 1) * entries_per_chunk) - entry;
+                char const *src = get_chunk(chunk).data() + (entry - chunk * entries_per_chunk) * entry_size;
+                if (is_native<T>(data_type)) std::copy_n(src, n * entry_size, (char*)p);
+                else convert(src, data_type, p, static_cast<size_t>(n) * layout.size());
+                entry += n;
+                p += n * layout.size();
+            }
+            return;
+        }
+
+        is.seekg(header_offset + first * entry_size, is.beg);
+        if (is_native<T>(data_type)) {
+            is.read((char*)p, count * entry_size);
+        } else {
+            raw.resize(count * entry_size);
+            is.read(raw.data(), raw.size());
+            convert(raw.data(), data_type, p, static_cast<size_t>(count) * layout.size());
+        }
+    }
+
+    /// Returns the decompressed chunk from the cache or the file
+    std::vector<char> const& get_chunk(uint32_t chunk)
+    {
+        auto&& cached = chunk_cache.find(chunk);
+        if (cached) return *cached;
+
+        uint64_t entry_size = layout.size() * get_size(data_type);
+        uint64_t number_of_chunk_entries = std::min(entries_per_chunk, number_of_entries - chunk * entries_per_chunk);
+
+        raw.resize(chunk_offsets[chunk + 1] - chunk_offsets[chunk]);
+        is.seekg(header_offset + chunk_offsets[chunk], is.beg);
+        is.read(raw.data(), raw.size());
+        if (!is) throw pink::exception("DataIterator: chunk " + std::to_string(chunk) + " can not be read");
+
+        std::vector<char> data(number_of_chunk_entries * entry_size);
+        lz4_decompress(raw.data(), raw.size(), data.data(), data.size());
+        return chunk_cache.insert(chunk, std::move(data));
+    }
+
     uint32_t number_of_entries;
 
     std::vector<uint32_t> random_list;
@@ -156,7 +269,10 @@ private:
 
     PtrDataType ptr_current_entry;
 
-    int header_offset;
+    uint64_t header_offset;
+
+    /// Data type of the entries in the file
+    FileDataType data_type;
 
     Layout layout;
 
@@ -164,6 +280,33 @@ private:
     bool end_flag;
 
     uint64_t seed;
+
+    /// Number of contiguous entries of the block shuffle (0 = full shuffle)
+    uint32_t block_size;
+
+    /// Positions in random_list after the last entry of each buffer
+    std::vector<uint32_t> buffer_ends;
+
+    /// Range of positions in random_list of the current buffer
+    size_t buffer_begin;
+    size_t buffer_end;
+
+    /// Sorted entries of the current buffer
+    std::vector<uint32_t> buffer_entries;
+
+    /// Data of the current buffer ordered as buffer_entries
+    std::vector<T> buffer;
+
+    /// Entries read from the file before the conversion or decompression
+    std::vector<char> raw;
+
+    /// Number of entries of a chunk for chunked data files, zero otherwise
+    uint32_t entries_per_chunk;
+
+    /// Positions of the chunks relative to header_offset, the last element is the end of the last chunk
+    std::vector<uint64_t> chunk_offsets;
+
+    LRUCache<uint32_t, std::vector<char>> chunk_cache;
 };
 
 } // namespace pink
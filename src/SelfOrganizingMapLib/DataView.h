@@ -0,0 +1,73 @@
+/**
+ * @file   SelfOrganizingMapLib/DataView.h
+ * @brief  Non-owning read-only view of a data point.
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include "Data.h"
+
+namespace pink {
+
+/// Read-only view of a data point in external storage, e.g. a memory-mapped file.
+/// The view is only valid as long as the storage exists.
+template <typename Layout, typename T>
+class DataView
+{
+public:
+
+    typedef T ValueType;
+    typedef DataView<Layout, T> SelfType;
+    typedef Layout LayoutType;
+    typedef typename LayoutType::DimensionType DimensionType;
+
+    /// Default construction
+    DataView()
+     : layout(),
+       ptr(nullptr)
+    {}
+
+    /// Construction from external storage
+    DataView(LayoutType const& layout, T const *ptr)
+     : layout(layout),
+       ptr(ptr)
+    {}
+
+    /// Construction from data, which must outlive the view
+    DataView(Data<Layout, T> const& data)
+     : layout(data.get_layout()),
+       ptr(data.get_data_pointer())
+    {}
+
+    auto size() const { return layout.size(); }
+
+    /// Returns the view itself, which provides the elements like the vector of @Data without copying
+    auto get_data() const -> SelfType const& { return *this; }
+
+    auto data() const { return ptr; }
+
+    auto begin() const { return ptr; }
+
+    auto end() const { return ptr + size(); }
+
+    /// Return the element
+    auto operator [] (uint32_t position) const -> T const& { return ptr[position]; }
+    auto operator [] (DimensionType const& position) const -> T const& { return ptr[layout.get_index(position)]; }
+
+    auto get_data_pointer() const { return ptr; }
+
+    auto get_layout() const -> LayoutType const { return layout; }
+
+    auto get_dimension() const -> DimensionType const { return layout.dimension; }
+
+private:
+
+    LayoutType layout;
+
+    T const *ptr;
+
+};
+
+} // namespace pink
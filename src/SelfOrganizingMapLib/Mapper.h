@@ -10,15 +10,23 @@
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <omp.h>
+#include <tuple>
 #include <vector>
 
 #include "Data.h"
+#include "DataView.h"
 #include "find_best_match.h"
 #include "generate_rotated_images.h"
 #include "generate_euclidean_distance_matrix.h"
+#include "generate_euclidean_distance_matrix_coarse_to_fine.h"
+#include "ScratchArena.h"
 #include "SOM.h"
 #include "SOMIO.h"
+#include "UtilitiesLib/AlignedAllocator.h"
+#include "UtilitiesLib/EuclideanDistanceBackend.h"
 #include "UtilitiesLib/Interpolation.h"
+#include "UtilitiesLib/PhaseTimer.h"
 #include "UtilitiesLib/pink_exception.h"
 
 #ifdef __CUDACC__
@@ -44,7 +52,7 @@ public:
        number_of_rotations(number_of_rotations),
        use_flip(use_flip),
        number_of_spatial_transformations(number_of_rotations * (use_flip ? 2 : 1)),
-       angle_step_radians(0.5 * M_PI / number_of_rotations / 4),
+       angle_step_radians(2.0 * M_PI / number_of_rotations),
        interpolation(interpolation),
        euclidean_distance_dim(euclidean_distance_dim)
     {
@@ -52,11 +60,47 @@ public:
             throw pink::exception("Number of rotations must be 1 or larger then 1 and divisible by 4");
 
         if (euclidean_distance_dim == -1) {
-            euclidean_distance_dim = som.get_neuron_dimension()[0];
-            if (number_of_rotations != 1) euclidean_distance_dim *= std::sqrt(2.0) / 2.0;
+            this->euclidean_distance_dim = som.get_neuron_dimension()[0];
+            if (number_of_rotations != 1) this->euclidean_distance_dim *= std::sqrt(2.0) / 2.0;
         }
     }
 
+    /// Returns if the spatial transformation flip * number_of_rotations + angle index is flipped
+    bool get_flip(uint32_t spatial_transformation) const
+    {
+        return spatial_transformation / number_of_rotations != 0;
+    }
+
+    /// Returns the rotation angle in radian of the spatial transformation flip * number_of_rotations + angle index
+    float get_angle(uint32_t spatial_transformation) const
+    {
+        return (spatial_transformation % number_of_rotations) * angle_step_radians;
+    }
+
+    /// Best matching neuron with its spatial transformation
+    struct BestMatch
+    {
+        uint32_t neuron;
+        float euclidean_distance;
+        bool flip;
+        float angle;
+    };
+
+    /// Returns the k best matching neurons of a mapping result sorted by the euclidean distance
+    template <typename ResultType>
+    std::vector<BestMatch> get_best_matches(ResultType const& result, uint32_t k) const
+    {
+        auto&& euclidean_distance_matrix = std::get<0>(result);
+        auto&& best_rotation_matrix = std::get<1>(result);
+
+        std::vector<BestMatch> best_matches;
+        for (auto&& neuron : find_best_matches(euclidean_distance_matrix, som.get_number_of_neurons(), k)) {
+            best_matches.push_back(BestMatch{neuron, static_cast<float>(euclidean_distance_matrix[neuron]),
+                get_flip(best_rotation_matrix[neuron]), get_angle(best_rotation_matrix[neuron])});
+        }
+        return best_matches;
+    }
+
 protected:
 
     /// A reference to the SOM will be trained
@@ -78,33 +122,215 @@ protected:
 template <typename SOMLayout, typename DataLayout, typename T, bool UseGPU>
 class Mapper;
 
-/// CPU version of training
+/// CPU version of mapping
+///
+/// The centered euclidean distance windows of the neurons are packed at construction,
+/// like the device copy of the SOM of the GPU version. The mapper works on this snapshot
+/// of the SOM, therefore update_som() must be called after the SOM was changed.
+///
+/// Each mapping call leases its own scratch arenas, so that a mapper can be used by several
+/// threads at the same time.
 template <typename SOMLayout, typename DataLayout, typename T>
 class Mapper<SOMLayout, DataLayout, T, false> : public MapperBase<SOMLayout, DataLayout, T>
 {
 public:
 
     Mapper(SOM<SOMLayout, DataLayout, T> const& som, int verbosity,
-        uint32_t number_of_rotations, bool use_flip, Interpolation interpolation, int euclidean_distance_dim = -1)
-     : MapperBase<SOMLayout, DataLayout, T>(som, verbosity, number_of_rotations, use_flip, interpolation, euclidean_distance_dim)
-    {}
+        uint32_t number_of_rotations, bool use_flip, Interpolation interpolation, int euclidean_distance_dim = -1,
+        EuclideanDistanceBackend euclidean_distance_backend = EuclideanDistanceBackend::DIRECT,
+        uint32_t coarse_rotation_step = 1, uint32_t number_of_refinement_candidates = 2)
+     : MapperBase<SOMLayout, DataLayout, T>(som, verbosity, number_of_rotations, use_flip, interpolation, euclidean_distance_dim),
+       euclidean_distance_backend(euclidean_distance_backend),
+       coarse_rotation_step(coarse_rotation_step),
+       number_of_refinement_candidates(number_of_refinement_candidates),
+       window_stride(get_window_stride<T>(this->euclidean_distance_dim)),
+       neuron_windows(static_cast<size_t>(som.get_number_of_neurons()) * window_stride),
+       neuron_window_norms(som.get_number_of_neurons()),
+       scratch_arenas(som.get_number_of_neurons(), this->number_of_spatial_transformations, som.get_neuron_size(),
+           window_stride),
+       rotation_plans(som.get_neuron_dimension()[0], number_of_rotations, interpolation)
+    {
+        if (this->euclidean_distance_dim < 0 or this->euclidean_distance_dim > static_cast<int>(som.get_neuron_dimension()[0]))
+            throw pink::exception("Dimension of euclidean distance calculation must not be larger than the neuron dimension");
+
+        update_som();
+    }
 
-    auto operator () (Data<DataLayout, T> const& data)
+    /// Repack the neuron windows from the SOM, which must be called after the SOM was changed.
+    /// Must not be called concurrently to a mapping call.
+    void update_som()
     {
+        pack_centered_windows(neuron_windows.data(), neuron_window_norms.data(), this->som.get_data_pointer(),
+            this->som.get_number_of_neurons(), this->som.get_neuron_dimension()[0], this->euclidean_distance_dim,
+            window_stride);
+    }
+
+    auto operator () (DataView<DataLayout, T> const& data)
+    {
+        std::vector<T> euclidean_distance_matrix;
+        std::vector<uint32_t> best_rotation_matrix;
+        operator()(data, euclidean_distance_matrix, best_rotation_matrix);
+        return std::make_tuple(std::move(euclidean_distance_matrix), std::move(best_rotation_matrix));
+    }
+
+    /// Mapping of a single data point into the given result vectors, which can be reused for the next
+    /// data point. The spatial transformations are generated in a scratch arena leased by the calling thread.
+    void operator () (DataView<DataLayout, T> const& data, std::vector<T>& euclidean_distance_matrix,
+        std::vector<uint32_t>& best_rotation_matrix)
+    {
+        auto&& lease = scratch_arenas.acquire();
+        ScratchArena<T>& arena = *lease;
+        transform(data, arena.spatial_transformed_images);
+        map(data, arena.spatial_transformed_images, euclidean_distance_matrix, best_rotation_matrix, arena);
+    }
+
+    /// Returns the spatial transformations of a data point, which can be prepared in advance.
+    /// For the coarse-to-fine search the transformations are generated on demand and the result is empty.
+    std::vector<T> transform(DataView<DataLayout, T> const& data) const
+    {
+        if (coarse_rotation_step > 1 and this->number_of_rotations > 1) return std::vector<T>();
+        return generate_rotated_images(data, this->number_of_rotations,
+            this->use_flip, this->interpolation, this->som.get_neuron_dimension()[0],
+            rotation_plans.get(data.get_dimension()[0]));
+    }
+
+    /// Same as above, the spatial transformations are written into the given vector,
+    /// which is only resized if it is too small
+    void transform(DataView<DataLayout, T> const& data, std::vector<T>& spatial_transformed_images) const
+    {
+        if (coarse_rotation_step > 1 and this->number_of_rotations > 1) return;
         uint32_t neuron_dim = this->som.get_neuron_dimension()[0];
+        size_t size = get_rotated_images_size(data, this->number_of_rotations, this->use_flip, neuron_dim);
+        if (spatial_transformed_images.size() < size) spatial_transformed_images.resize(size);
+        generate_rotated_images(&spatial_transformed_images[0], data, this->number_of_rotations,
+            this->use_flip, this->interpolation, neuron_dim, rotation_plans.get(data.get_dimension()[0]));
+    }
 
-        auto&& spatial_transformed_images = generate_rotated_images(data, this->number_of_rotations,
-            this->use_flip, this->interpolation, neuron_dim);
+    /// Mapping of a single data point with the spatial transformations prepared by transform()
+    auto operator () (DataView<DataLayout, T> const& data, std::vector<T> const& spatial_transformed_images)
+    {
+        std::vector<T> euclidean_distance_matrix;
+        std::vector<uint32_t> best_rotation_matrix;
+        operator()(data, spatial_transformed_images, euclidean_distance_matrix, best_rotation_matrix);
+        return std::make_tuple(std::move(euclidean_distance_matrix), std::move(best_rotation_matrix));
+    }
 
-        std::vector<T> euclidean_distance_matrix(this->som.get_number_of_neurons());
-        std::vector<uint32_t> best_rotation_matrix(this->som.get_number_of_neurons());
+    /// Same as above with given result vectors, which can be reused for the next data point
+    void operator () (DataView<DataLayout, T> const& data, std::vector<T> const& spatial_transformed_images,
+        std::vector<T>& euclidean_distance_matrix, std::vector<uint32_t>& best_rotation_matrix)
+    {
+        auto&& lease = scratch_arenas.acquire();
+        map(data, spatial_transformed_images, euclidean_distance_matrix, best_rotation_matrix, *lease);
+    }
 
-        generate_euclidean_distance_matrix(euclidean_distance_matrix, best_rotation_matrix,
-            this->som.get_number_of_neurons(), this->som.get_data_pointer(), neuron_dim, this->number_of_spatial_transformations,
-            spatial_transformed_images, this->euclidean_distance_dim);
+    /// Mapping of a batch of data points or data views, which are distributed over the threads.
+    /// Each thread maps whole data points with its own buffers. The results are returned in the
+    /// order of the batch and are identical to the mapping of the single data points.
+    template <typename DataPointType>
+    std::vector<std::tuple<std::vector<T>, std::vector<uint32_t>>> map_batch(std::vector<DataPointType> const& batch)
+    {
+        std::vector<std::tuple<std::vector<T>, std::vector<uint32_t>>> results(batch.size());
+        if (batch.empty()) return results;
+
+        bool coarse_to_fine = coarse_rotation_step > 1 and this->number_of_rotations > 1;
+        if (coarse_to_fine) {
+            for (auto&& data : batch) {
+                if (DataView<DataLayout, T>(data).get_layout().dimensionality != 2)
+                    throw pink::exception("Coarse-to-fine rotation search needs two-dimensional data.");
+            }
+        }
+
+        int number_of_threads = std::max(1, std::min(omp_get_max_threads(), static_cast<int>(batch.size())));
+
+        #pragma omp parallel num_threads(number_of_threads)
+        {
+            auto&& lease = scratch_arenas.acquire();
+            ScratchArena<T>& arena = *lease;
+
+            #pragma omp for schedule(dynamic)
+            for (int n = 0; n < static_cast<int>(batch.size()); ++n)
+            {
+                DataView<DataLayout, T> data(batch[n]);
+                auto&& euclidean_distance_matrix = std::get<0>(results[n]);
+                auto&& best_rotation_matrix = std::get<1>(results[n]);
+                if (coarse_to_fine) {
+                    map_coarse_to_fine(data, euclidean_distance_matrix, best_rotation_matrix, arena);
+                } else {
+                    transform(data, arena.spatial_transformed_images);
+                    map(data, arena.spatial_transformed_images, euclidean_distance_matrix, best_rotation_matrix, arena);
+                }
+            }
+        }
 
-        return std::make_tuple(euclidean_distance_matrix, best_rotation_matrix);
+        return results;
     }
+
+private:
+
+    /// Mapping of a single data point with prepared spatial transformations into the given result vectors
+    void map(DataView<DataLayout, T> const& data, std::vector<T> const& spatial_transformed_images,
+        std::vector<T>& euclidean_distance_matrix, std::vector<uint32_t>& best_rotation_matrix, ScratchArena<T>& arena) const
+    {
+        if (coarse_rotation_step > 1 and this->number_of_rotations > 1) {
+            if (data.get_layout().dimensionality != 2) throw pink::exception("Coarse-to-fine rotation search needs two-dimensional data.");
+            map_coarse_to_fine(data, euclidean_distance_matrix, best_rotation_matrix, arena);
+            return;
+        }
+
+        euclidean_distance_matrix.resize(this->som.get_number_of_neurons());
+        best_rotation_matrix.resize(this->som.get_number_of_neurons());
+
+        // The neurons are taken from the packed windows, only the transformed images must be packed
+        pack_centered_windows(arena.image_windows.data(), arena.image_window_norms.data(),
+            spatial_transformed_images.data(), this->number_of_spatial_transformations,
+            this->som.get_neuron_dimension()[0], this->euclidean_distance_dim, window_stride);
+
+        generate_euclidean_distance_matrix_packed(euclidean_distance_matrix, best_rotation_matrix,
+            this->som.get_number_of_neurons(), neuron_windows.data(), neuron_window_norms.data(),
+            this->number_of_spatial_transformations, arena.image_windows.data(), arena.image_window_norms.data(),
+            window_stride, euclidean_distance_backend, arena.dot_products);
+    }
+
+    /// Coarse-to-fine search of the best rotation, the spatial transformations are generated on demand
+    /// in the scratch arena
+    void map_coarse_to_fine(DataView<DataLayout, T> const& data, std::vector<T>& euclidean_distance_matrix,
+        std::vector<uint32_t>& best_rotation_matrix, ScratchArena<T>& arena) const
+    {
+        euclidean_distance_matrix.resize(this->som.get_number_of_neurons());
+        best_rotation_matrix.resize(this->som.get_number_of_neurons());
+
+        generate_euclidean_distance_matrix_coarse_to_fine(euclidean_distance_matrix, best_rotation_matrix,
+            this->som.get_number_of_neurons(), neuron_windows.data(), data.get_data_pointer(), data.get_dimension()[0],
+            this->som.get_neuron_dimension()[0], this->number_of_rotations, this->use_flip, this->interpolation,
+            this->euclidean_distance_dim, coarse_rotation_step, number_of_refinement_candidates,
+            arena.spatial_transformed_images, arena.image_windows, window_stride,
+            rotation_plans.get(data.get_dimension()[0]));
+    }
+
+    /// Algorithm for the calculation of the euclidean distance matrix
+    EuclideanDistanceBackend euclidean_distance_backend;
+
+    /// Angle step of the coarse rotation search (1 = exhaustive search)
+    uint32_t coarse_rotation_step;
+
+    /// Number of coarse transformations per neuron which are refined
+    uint32_t number_of_refinement_candidates;
+
+    /// Distance of the packed windows, see @get_window_stride
+    uint32_t window_stride;
+
+    /// Contiguous copy of the centered euclidean distance window of each neuron,
+    /// each window starts at a cache line and is padded with zeros
+    AlignedVector<T> neuron_windows;
+
+    /// Squared norm of each neuron window
+    std::vector<T> neuron_window_norms;
+
+    /// Reusable buffers of the spatial transformations, leased by each mapping thread
+    ScratchArenas<T> scratch_arenas;
+
+    /// Bilinear rotation plans of the spatial transformations
+    BilinearRotationPlanCache rotation_plans;
 };
 
 
@@ -144,31 +370,78 @@ public:
         }
     }
 
-    /// Training the SOM by a single data point
-    auto operator () (Data<DataLayout, T> const& data)
+    /// Copy the SOM to the device again, which must be called after the SOM was changed
+    void update_som()
+    {
+        d_som = this->som.get_data();
+    }
+
+    /// Mapping of a single data point
+    auto operator () (DataView<DataLayout, T> const& data)
+    {
+        std::vector<T> euclidean_distance_matrix;
+        std::vector<uint32_t> best_rotation_matrix;
+        operator()(data, euclidean_distance_matrix, best_rotation_matrix);
+        return std::make_tuple(std::move(euclidean_distance_matrix), std::move(best_rotation_matrix));
+    }
+
+    /// Mapping of a single data point into the given result vectors, which can be reused for the next data point
+    void operator () (DataView<DataLayout, T> const& data, std::vector<T>& euclidean_distance_matrix,
+        std::vector<uint32_t>& best_rotation_matrix)
     {
-        /// Device memory for data
-        thrust::device_vector<T> d_data = data.get_data();
+        /// Device memory for data, copied directly from the view
+        thrust::device_vector<T> d_data(data.get_data_pointer(), data.get_data_pointer() + data.size());
 
         uint32_t neuron_dim = this->som.get_neuron_dimension()[0];
         uint32_t neuron_size = neuron_dim * neuron_dim;
         uint32_t spacing = data.get_layout().dimensionality > 2 ? data.get_dimension()[2] : 1;
         for (uint32_t i = 3; i < data.get_layout().dimensionality; ++i) spacing *= data.get_dimension()[i];
 
-        generate_rotated_images(d_spatial_transformed_images, d_data, spacing, this->number_of_rotations,
-            data.get_dimension()[0], neuron_dim, this->use_flip, this->interpolation, d_cos_alpha, d_sin_alpha);
+        {
+            ScopedPhaseTimer timer(Phase::ROTATION);
+            generate_rotated_images(d_spatial_transformed_images, d_data, spacing, this->number_of_rotations,
+                data.get_dimension()[0], neuron_dim, this->use_flip, this->interpolation, d_cos_alpha, d_sin_alpha);
+        }
 
+        ScopedPhaseTimer timer(Phase::DISTANCE);
         generate_euclidean_distance_matrix(d_euclidean_distance_matrix, d_best_rotation_matrix,
             this->som.get_number_of_neurons(), neuron_size, d_som, this->number_of_spatial_transformations,
             d_spatial_transformed_images, block_size, euclidean_distance_type, this->euclidean_distance_dim);
 
-        std::vector<T> euclidean_distance_matrix(this->som.get_number_of_neurons());
-        std::vector<uint32_t> best_rotation_matrix(this->som.get_number_of_neurons());
+        euclidean_distance_matrix.resize(this->som.get_number_of_neurons());
+        best_rotation_matrix.resize(this->som.get_number_of_neurons());
 
         thrust::copy(d_euclidean_distance_matrix.begin(), d_euclidean_distance_matrix.end(), &euclidean_distance_matrix[0]);
         thrust::copy(d_best_rotation_matrix.begin(), d_best_rotation_matrix.end(), &best_rotation_matrix[0]);
+    }
 
-        return std::make_tuple(euclidean_distance_matrix, best_rotation_matrix);
+    /// The spatial transformations are generated on the device, the result is empty
+    std::vector<T> transform(DataView<DataLayout, T> const&) const
+    {
+        return std::vector<T>();
+    }
+
+    /// Mapping of a single data point, see transform()
+    auto operator () (DataView<DataLayout, T> const& data, std::vector<T> const&)
+    {
+        return operator()(data);
+    }
+
+    /// Same as above with given result vectors
+    void operator () (DataView<DataLayout, T> const& data, std::vector<T> const&,
+        std::vector<T>& euclidean_distance_matrix, std::vector<uint32_t>& best_rotation_matrix)
+    {
+        operator()(data, euclidean_distance_matrix, best_rotation_matrix);
+    }
+
+    /// The data points of the batch are mapped sequentially on the device
+    template <typename DataPointType>
+    std::vector<std::tuple<std::vector<T>, std::vector<uint32_t>>> map_batch(std::vector<DataPointType> const& batch)
+    {
+        std::vector<std::tuple<std::vector<T>, std::vector<uint32_t>>> results;
+        results.reserve(batch.size());
+        for (auto&& data : batch) results.push_back(operator()(data));
+        return results;
     }
 
 private:
@@ -0,0 +1,274 @@
+/**
+ * @file   SelfOrganizingMapLib/MmapDataIterator.h
+ * @brief  Lazy iterator with random access for reading data of a memory-mapped file.
+ *
+ * The entries are not copied, but exposed as views into the mapping. The order of the
+ * entries is identical to @DataIterator with the same seed. As the entries are accessed
+ * in random order, the read-ahead of the kernel is switched off and the next entries of
+ * the shuffled order, or the whole next buffer of the block shuffle, are requested in advance.
+ * Files with a reduced precision data type and chunked data files can not be mapped and are
+ * read by @DataIterator.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <vector>
+
+#include "DataView.h"
+#include "ShuffleOrder.h"
+#include "UtilitiesLib/FileDataType.h"
+#include "UtilitiesLib/MemoryMappedFile.h"
+#include "UtilitiesLib/PhaseTimer.h"
+#include "UtilitiesLib/pink_exception.h"
+
+namespace pink {
+
+/// Lazy iterator with random access for reading data of a memory-mapped file
+template <typename Layout, typename T>
+class MmapDataIterator
+{
+public:
+
+    typedef DataView<Layout, T> DataType;
+
+    /// Number of entries in shuffled order, which are requested in advance
+    static const uint32_t prefetch_distance = 8;
+
+    /// Default constructor
+    MmapDataIterator(std::string const&, bool end_flag)
+     : number_of_entries(0),
+       file_type(0),
+       data_type(FileDataType::FLOAT32),
+       header_offset(0),
+       end_flag(end_flag),
+       seed(1234)
+    {}
+
+    /// Parameter constructor
+    ///
+    /// For a block_size larger than zero the entries are block-shuffled (see @get_block_shuffled_order)
+    /// and the contiguous ranges of a buffer are requested at once when the first entry of the buffer is taken.
+    MmapDataIterator(std::string const& filename, uint64_t seed = 1234, uint32_t block_size = 0, uint32_t buffer_size = 0)
+     : number_of_entries(0),
+       file(std::make_shared<MemoryMappedFile>(filename)),
+       header_offset(read_header(*file, filename, layout, number_of_entries, file_type, data_type)),
+       end_flag(false),
+       seed(seed),
+       block_size(block_size)
+    {
+        if (file_type != 0)
+            throw pink::exception("Chunked data file " + filename + " can not be memory mapped.");
+        if (!is_native<T>(data_type))
+            throw pink::exception("Entries of data file " + filename + " must be converted and can not be memory mapped.");
+        if (header_offset % alignof(T) != 0)
+            throw pink::exception("Entries of data file " + filename + " are not aligned for memory mapping.");
+
+        random_list = get_block_shuffled_order(number_of_entries, block_size, buffer_size, seed, buffer_ends);
+
+        file->advise(header_offset, number_of_entries * get_entry_size(), MADV_RANDOM);
+
+        set_to_begin();
+    }
+
+    /// Returns true if the entries of the data file can be accessed by views,
+    /// which requires an uncompressed file, the data type T and the alignment of the binary data for T
+    static bool is_applicable(std::string const& filename)
+    {
+        Layout layout;
+        uint32_t number_of_entries;
+        int file_type;
+        FileDataType data_type;
+        size_t header_offset = read_header(MemoryMappedFile(filename), filename, layout, number_of_entries,
+            file_type, data_type);
+        return file_type == 0 and is_native<T>(data_type) and header_offset % alignof(T) == 0;
+    }
+
+    /// Equal comparison
+    bool operator == (MmapDataIterator const& other) const
+    {
+        return end_flag == other.end_flag;
+    }
+
+    /// Unequal comparison
+    bool operator != (MmapDataIterator const& other) const
+    {
+        return !operator==(other);
+    }
+
+    /// Prefix increment
+    MmapDataIterator& operator ++ ()
+    {
+        next();
+        return *this;
+    }
+
+    /// Addition assignment operator
+    MmapDataIterator& operator += (int steps)
+    {
+        cur_random_list += steps;
+        for (uint32_t i = 0; i != prefetch_distance; ++i) prefetch(i);
+        next();
+        return *this;
+    }
+
+    /// Set to first position
+    void set_to_begin()
+    {
+        set_to_position(0);
+    }
+
+    /// Set to the position in the order of the entries, used to resume an interrupted iteration
+    void set_to_position(uint32_t position)
+    {
+        cur_random_list = std::begin(random_list) + std::min(static_cast<size_t>(position), random_list.size());
+        end_flag = false;
+        for (uint32_t i = 0; i != prefetch_distance; ++i) prefetch(i);
+        next();
+    }
+
+    /// Dereference
+    DataType const& operator * () const
+    {
+        return current_entry;
+    }
+
+    /// Dereference
+    DataType const* operator -> () const
+    {
+        return &(operator*());
+    }
+
+    /// Return number of images.
+    int get_number_of_entries() const { return number_of_entries; }
+
+private:
+
+    /// Reads the layout, the number of entries and the data type and returns the position of the first entry.
+    /// For chunked data files only the file type is read, other file types are rejected.
+    static size_t read_header(MemoryMappedFile const& file, std::string const& filename, Layout& layout,
+        uint32_t& number_of_entries, int& file_type, FileDataType& data_type)
+    {
+        char const *begin = file.data();
+        char const *end = begin + file.size();
+
+        // Skip all header lines starting with #
+        size_t binary_start_position = 0;
+        for (char const *line = begin; line != end and *line == '#';) {
+            char const *line_end = std::find(line, end, '\n');
+            if (std::string(line, line_end) == "# END OF HEADER") {
+                binary_start_position = std::min(line_end + 1, end) - begin;
+                break;
+            }
+            line = line_end == end ? end : line_end + 1;
+        }
+
+        // <file format version> 0 <data-type> <number of entries> <layout> <dimensionality> <dimensions>
+        auto&& read_int = [&](size_t position) {
+            if (binary_start_position + (position + 1) * sizeof(int) > file.size())
+                throw pink::exception("Data file " + filename + " is too short.");
+            int value;
+            std::memcpy(&value, begin + binary_start_position + position * sizeof(int), sizeof(int));
+            return value;
+        };
+
+        file_type = read_int(1);
+        if (file_type == 4) return 0;
+        if (file_type != 0) throw pink::exception(filename + " is not a data file.");
+
+        data_type = get_file_data_type(read_int(2));
+        number_of_entries = read_int(3);
+        if (read_int(5) != layout.dimensionality)
+            throw pink::exception("Dimensionality of data file " + filename + " does not match.");
+        for (int i = 0; i < layout.dimensionality; ++i) {
+            layout.dimension[i] = read_int(6 + i);
+        }
+
+        size_t header_offset = binary_start_position + (6 + layout.dimensionality) * sizeof(int);
+        if (header_offset + static_cast<size_t>(number_of_entries) * layout.size() * get_size(data_type) > file.size())
+            throw pink::exception("Data file " + filename + " is too short.");
+
+        return header_offset;
+    }
+
+    /// Size of an entry in bytes
+    size_t get_entry_size() const { return layout.size() * sizeof(T); }
+
+    /// Request the entry at the given distance ahead of the current position
+    void prefetch(uint32_t distance) const
+    {
+        if (block_size != 0 or static_cast<size_t>(std::end(random_list) - cur_random_list) <= distance) return;
+        file->advise(header_offset + cur_random_list[distance] * get_entry_size(), get_entry_size(), MADV_WILLNEED);
+    }
+
+    /// Request the contiguous ranges of the buffer, if the position is the first one of a buffer
+    void prefetch_buffer(size_t position) const
+    {
+        if (block_size == 0) return;
+        auto&& iter_buffer_end = std::upper_bound(std::begin(buffer_ends), std::end(buffer_ends), position);
+        size_t buffer_begin = iter_buffer_end == std::begin(buffer_ends) ? 0 : *(iter_buffer_end - 1);
+        if (position != buffer_begin) return;
+
+        std::vector<uint32_t> buffer_entries(std::begin(random_list) + buffer_begin, std::begin(random_list) + *iter_buffer_end);
+        std::sort(std::begin(buffer_entries), std::end(buffer_entries));
+        for (auto&& range : get_contiguous_ranges(buffer_entries)) {
+            file->advise(header_offset + range.first * get_entry_size(), range.second * get_entry_size(), MADV_WILLNEED);
+        }
+    }
+
+    /// Set view to next entry
+    void next()
+    {
+        ScopedPhaseTimer timer(Phase::IO);
+
+        if (cur_random_list != std::end(random_list)) {
+            prefetch_buffer(cur_random_list - std::begin(random_list));
+            current_entry = DataType(layout, reinterpret_cast<T const*>(
+                file->data() + header_offset + *cur_random_list * get_entry_size()));
+            ++cur_random_list;
+            prefetch(prefetch_distance - 1);
+        } else {
+            end_flag = true;
+        }
+    }
+
+    uint32_t number_of_entries;
+
+    std::vector<uint32_t> random_list;
+
+    std::vector<uint32_t>::const_iterator cur_random_list;
+
+    /// Shared by all copies of the iterator, the views are valid as long as one copy exists
+    std::shared_ptr<MemoryMappedFile> file;
+
+    DataType current_entry;
+
+    Layout layout;
+
+    int file_type;
+
+    /// Data type of the entries in the file, must be T for views
+    FileDataType data_type;
+
+    size_t header_offset;
+
+    /// Define the end iterator
+    bool end_flag;
+
+    uint64_t seed;
+
+    /// Number of contiguous entries of the block shuffle (0 = full shuffle)
+    uint32_t block_size;
+
+    /// Positions in random_list after the last entry of each buffer
+    std::vector<uint32_t> buffer_ends;
+};
+
+} // namespace pink
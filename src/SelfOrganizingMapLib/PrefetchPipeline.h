@@ -0,0 +1,171 @@
+/**
+ * @file   SelfOrganizingMapLib/PrefetchPipeline.h
+ * @brief  Asynchronous reading and transformation of data points.
+ *
+ * A reader thread takes the data points from the iterator, a transform thread prepares
+ * them (e.g. generates the spatial transformations), and the calling thread consumes them.
+ * The stages are connected by bounded lock-free queues, so that the reading and the
+ * transformation of the next data points overlap with the computation of the current one.
+ * The order of the data points is preserved.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <omp.h>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+#include "DataView.h"
+#include "UtilitiesLib/SPSCQueue.h"
+
+namespace pink {
+
+template <typename Iterator, typename TransformedType>
+class PrefetchPipeline
+{
+public:
+
+    /// Data points of the iterator, views are not copied
+    typedef typename std::decay<decltype(*std::declval<Iterator&>())>::type DataPointType;
+
+    typedef std::function<TransformedType(DataPointType const&)> TransformFunction;
+
+    struct Item
+    {
+        DataPointType data;
+        TransformedType transformed;
+    };
+
+    /// Starts reading at the current position of the iterator. The iterator must not be used
+    /// by others until the pipeline is destroyed. At most queue_size data points are buffered
+    /// in each stage. The transformation uses number_of_transform_threads OpenMP threads, which are
+    /// taken from the thread budget of the calling thread until the pipeline is destroyed, so that
+    /// the transformation and the computation together do not oversubscribe the cores.
+    PrefetchPipeline(Iterator& iter_cur, Iterator const& iter_end, uint32_t queue_size,
+        TransformFunction const& transform, int number_of_transform_threads = 1)
+     : read_queue(queue_size),
+       transform_queue(queue_size),
+       cancelled(false),
+       read_error(nullptr),
+       transform_error(nullptr),
+       number_of_compute_threads(omp_get_max_threads())
+    {
+        omp_set_num_threads(std::max(1, number_of_compute_threads - number_of_transform_threads));
+
+        reader = std::thread([this, &iter_cur, iter_end]() {
+            try {
+                for (; iter_cur != iter_end; ++iter_cur) {
+                    DataPointType data = *iter_cur;
+                    prefault(data);
+                    if (!read_queue.push(data, is_cancelled())) break;
+                }
+            } catch (...) {
+                read_error = std::current_exception();
+            }
+            read_queue.close();
+        });
+
+        transformer = std::thread([this, transform, number_of_transform_threads]() {
+            omp_set_num_threads(number_of_transform_threads);
+            try {
+                Item item;
+                while (read_queue.pop(item.data, is_cancelled())) {
+                    item.transformed = transform(item.data);
+                    if (!transform_queue.push(item, is_cancelled())) break;
+                }
+            } catch (...) {
+                transform_error = std::current_exception();
+            }
+            transform_queue.close();
+        });
+    }
+
+    ~PrefetchPipeline()
+    {
+        cancel();
+        if (reader.joinable()) reader.join();
+        if (transformer.joinable()) transformer.join();
+        omp_set_num_threads(number_of_compute_threads);
+    }
+
+    PrefetchPipeline(PrefetchPipeline const&) = delete;
+    PrefetchPipeline& operator = (PrefetchPipeline const&) = delete;
+
+    /// Waits for the next data point. Returns false at the end of the data.
+    /// Exceptions of the reader and the transformation are rethrown.
+    bool pop(Item& item)
+    {
+        if (transform_queue.pop(item, [](){ return false; })) return true;
+
+        // The reader may still wait if the transformation failed
+        cancel();
+        if (transformer.joinable()) transformer.join();
+        if (reader.joinable()) reader.join();
+        if (read_error) std::rethrow_exception(read_error);
+        if (transform_error) std::rethrow_exception(transform_error);
+        return false;
+    }
+
+private:
+
+    /// Stops the reader and the transformation and wakes them up if they are waiting
+    void cancel()
+    {
+        cancelled = true;
+        read_queue.notify();
+        transform_queue.notify();
+    }
+
+    /// Returns the cancel condition for the queues
+    std::function<bool()> is_cancelled() const
+    {
+        return [this](){ return cancelled.load(); };
+    }
+
+    /// Data points, which are not views, are read completely by the iterator
+    template <typename D>
+    static void prefault(D const&)
+    {}
+
+    /// The pages of views are touched to load them from the file into memory
+    template <typename Layout, typename T>
+    static void prefault(DataView<Layout, T> const& data)
+    {
+        static const size_t page_size = ::sysconf(_SC_PAGESIZE);
+        char const *begin = reinterpret_cast<char const*>(data.get_data_pointer());
+        char const *end = begin + data.size() * sizeof(T);
+        volatile char sink = 0;
+        for (char const *p = begin; p < end; p += page_size) sink = *p;
+        if (begin != end) sink = *(end - 1);
+        static_cast<void>(sink);
+    }
+
+    SPSCQueue<DataPointType> read_queue;
+
+    SPSCQueue<Item> transform_queue;
+
+    std::atomic<bool> cancelled;
+
+    std::exception_ptr read_error;
+
+    std::exception_ptr transform_error;
+
+    /// Number of OpenMP threads of the calling thread before the pipeline was started
+    int number_of_compute_threads;
+
+    std::thread reader;
+
+    std::thread transformer;
+};
+
+} // namespace pink
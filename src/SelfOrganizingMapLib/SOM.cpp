@@ -14,7 +14,9 @@ SOM<CartesianLayout<1>, CartesianLayout<2>, float>::SOM(InputData const& input_d
  : som_layout{{input_data.som_width}},
    neuron_layout{{input_data.neuron_dim, input_data.neuron_dim}},
    data(som_layout.size() * neuron_layout.size())
-{}
+{
+    first_touch(&data[0], data.size());
+}
 
 template <>
 SOM<CartesianLayout<2>, CartesianLayout<2>, float>::SOM(InputData const& input_data)
@@ -22,6 +24,8 @@ SOM<CartesianLayout<2>, CartesianLayout<2>, float>::SOM(InputData const& input_d
    neuron_layout{{input_data.neuron_dim, input_data.neuron_dim}},
    data(som_layout.size() * neuron_layout.size())
 {
+    first_touch(&data[0], data.size());
+
     // Initialize SOM
     if (input_data.init == SOMInitialization::ZERO)
         fill_value(&data[0], data.size());
@@ -94,13 +98,17 @@ SOM<CartesianLayout<3>, CartesianLayout<2>, float>::SOM(InputData const& input_d
  : som_layout{{input_data.som_width, input_data.som_height, input_data.som_depth}},
    neuron_layout{{input_data.neuron_dim, input_data.neuron_dim}},
    data(som_layout.size() * neuron_layout.size())
-{}
+{
+    first_touch(&data[0], data.size());
+}
 
 template <>
 SOM<HexagonalLayout, CartesianLayout<2>, float>::SOM(InputData const& input_data)
  : som_layout{{input_data.som_width, input_data.som_height}},
    neuron_layout{{input_data.neuron_dim, input_data.neuron_dim}},
    data(som_layout.size() * neuron_layout.size())
-{}
+{
+    first_touch(&data[0], data.size());
+}
 
 } // namespace pink
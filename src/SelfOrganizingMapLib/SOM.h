@@ -9,11 +9,14 @@
 #include <array>
 #include <fstream>
 #include <functional>
+#include <utility>
 #include <vector>
 
 #include "CartesianLayout.h"
 #include "Data.h"
+#include "DataView.h"
 #include "HexagonalLayout.h"
+#include "UtilitiesLib/AlignedAllocator.h"
 #include "UtilitiesLib/InputData.h"
 
 namespace pink {
@@ -39,34 +42,45 @@ public:
     /// Construction by input data
     SOM(InputData const& input_data);
 
-    /// Construction without initialization
+    /// Construction and initialize all elements to zero
     SOM(SOMLayoutType const& som_layout, NeuronLayoutType const& neuron_layout)
-     : som_layout(som_layout),
-       neuron_layout(neuron_layout),
-       data(som_layout.size() * neuron_layout.size())
+     : SOM(som_layout, neuron_layout, T())
     {}
 
     /// Construction and initialize all elements to value
     SOM(SOMLayoutType const& som_layout, NeuronLayoutType const& neuron_layout, T value)
      : som_layout(som_layout),
        neuron_layout(neuron_layout),
-       data(som_layout.size() * neuron_layout.size(), value)
-    {}
+       data(som_layout.size() * neuron_layout.size())
+    {
+        first_touch(data.data(), data.size(), value);
+    }
 
-    /// Construction and copy data
+    /// Construction and copy data into the aligned storage
     SOM(SOMLayoutType const& som_layout, NeuronLayoutType const& neuron_layout,
         std::vector<T> const& data)
      : som_layout(som_layout),
        neuron_layout(neuron_layout),
-       data(data)
-    {}
+       data(data.size())
+    {
+        first_touch(this->data.data(), data.data(), data.size());
+    }
 
-    /// Construction and move data
+    /// Construction from a temporary std::vector, whose elements are copied once into the
+    /// aligned storage and released afterwards. Use AlignedVector to avoid the copy.
     SOM(SOMLayoutType const& som_layout, NeuronLayoutType const& neuron_layout,
         std::vector<T>&& data)
+     : SOM(som_layout, neuron_layout, static_cast<std::vector<T> const&>(data))
+    {
+        std::vector<T>().swap(data);
+    }
+
+    /// Construction and move data
+    SOM(SOMLayoutType const& som_layout, NeuronLayoutType const& neuron_layout,
+        AlignedVector<T>&& data)
      : som_layout(som_layout),
        neuron_layout(neuron_layout),
-       data(data)
+       data(std::move(data))
     {}
 
     auto operator == (SelfType const& other) const
@@ -78,16 +92,17 @@ public:
 
     auto size() const { return data.size(); }
 
-    auto get_data() { return data; }
-    auto get_data() const { return data; }
+    /// Returns the elements without copy, the elements of a temporary are moved
+    auto get_data() const & -> AlignedVector<T> const& { return data; }
+    auto get_data() && -> AlignedVector<T> { return std::move(data); }
 
     auto get_data_pointer() { return &data[0]; }
     auto get_data_pointer() const { return &data[0]; }
 
-    auto get_neuron(SOMLayoutType const& position) {
-        auto&& beg = data.begin() + (position.dimension[0] * som_layout.dimension[1] + position.dimension[1]) * neuron_layout.size();
-        auto&& end = beg + neuron_layout.size();
-        return NeuronType(neuron_layout, std::vector<T>(beg, end));
+    /// Returns a view of the neuron, which is only valid as long as the SOM exists
+    auto get_neuron(SOMLayoutType const& position) const {
+        auto&& index = position.dimension[0] * som_layout.dimension[1] + position.dimension[1];
+        return DataView<NeuronLayout, T>(neuron_layout, &data[index * neuron_layout.size()]);
     }
 
     auto get_number_of_neurons() const -> uint32_t const { return som_layout.size(); }
@@ -118,7 +133,8 @@ private:
     // Header of initialization SOM, will be copied to resulting SOM
     std::string header;
 
-    std::vector<T> data;
+    /// Aligned storage of the neurons, which is first touched with the static OpenMP partition
+    AlignedVector<T> data;
 
 };
 
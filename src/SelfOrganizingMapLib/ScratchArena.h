@@ -0,0 +1,141 @@
+/**
+ * @file   SelfOrganizingMapLib/ScratchArena.h
+ * @brief  Reusable per-thread buffers for the best match search of single data points.
+ *
+ * The spatial transformations, the packed windows, and the distance results of a data point
+ * are only needed until the next data point is processed. Instead of allocating them for each
+ * data point, a thread leases an arena from the pool of the trainer or mapper, which is
+ * allocated by the first leasing thread (first touch) and reused by all following leases.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "UtilitiesLib/AlignedAllocator.h"
+
+namespace pink {
+
+/// Buffers of a single thread
+template <typename T>
+struct ScratchArena
+{
+    ScratchArena(uint32_t som_size, uint32_t number_of_spatial_transformations, uint32_t neuron_size,
+        uint32_t window_stride)
+     : spatial_transformed_images(static_cast<size_t>(number_of_spatial_transformations) * neuron_size),
+       image_windows(static_cast<size_t>(number_of_spatial_transformations) * window_stride),
+       image_window_norms(number_of_spatial_transformations),
+       euclidean_distance_matrix(som_size),
+       best_rotation_matrix(som_size),
+       neuron_buffers(3 * static_cast<size_t>(neuron_size))
+    {}
+
+    /// Spatial transformed images of the current data point
+    std::vector<T> spatial_transformed_images;
+
+    /// Packed centered windows of the spatial transformed images (see @pack_centered_windows)
+    AlignedVector<T> image_windows;
+
+    /// Squared norm of each image window
+    std::vector<T> image_window_norms;
+
+    /// Minimal euclidean distance of each neuron
+    std::vector<T> euclidean_distance_matrix;
+
+    /// Spatial transformation of the minimal euclidean distance of each neuron
+    std::vector<uint32_t> best_rotation_matrix;
+
+    /// Dot products of all neuron and image windows, only used and sized by the GEMM backend
+    std::vector<T> dot_products;
+
+    /// Three buffers with the size of a neuron, e.g. for the accumulated update of a neuron
+    /// and a single spatial transformation with its intermediate result
+    std::vector<T> neuron_buffers;
+};
+
+/// Pool of arenas, see file description
+///
+/// An arena is leased by a thread for the processing of one or more data points and
+/// returned at the end of the lease. Each lease has its own arena, therefore the owner
+/// of the pool can be used from several OpenMP teams or other threads at the same time.
+template <typename T>
+class ScratchArenas
+{
+public:
+
+    /// Exclusive use of an arena, which is returned to the pool at destruction
+    class Lease
+    {
+    public:
+
+        Lease(ScratchArenas& pool, std::unique_ptr<ScratchArena<T>>&& arena)
+         : pool(&pool),
+           arena(std::move(arena))
+        {}
+
+        Lease(Lease&& other) = default;
+
+        Lease(Lease const&) = delete;
+        Lease& operator = (Lease const&) = delete;
+
+        ~Lease()
+        {
+            if (arena) pool->release(std::move(arena));
+        }
+
+        ScratchArena<T>& operator * () const { return *arena; }
+
+    private:
+
+        ScratchArenas *pool;
+        std::unique_ptr<ScratchArena<T>> arena;
+    };
+
+    ScratchArenas(uint32_t som_size, uint32_t number_of_spatial_transformations, uint32_t neuron_size,
+        uint32_t window_stride)
+     : som_size(som_size),
+       number_of_spatial_transformations(number_of_spatial_transformations),
+       neuron_size(neuron_size),
+       window_stride(window_stride)
+    {}
+
+    /// Returns a free arena or a new one, which is allocated by the calling thread
+    Lease acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!free_arenas.empty()) {
+                Lease lease(*this, std::move(free_arenas.back()));
+                free_arenas.pop_back();
+                return lease;
+            }
+        }
+        return Lease(*this, std::unique_ptr<ScratchArena<T>>(
+            new ScratchArena<T>(som_size, number_of_spatial_transformations, neuron_size, window_stride)));
+    }
+
+private:
+
+    void release(std::unique_ptr<ScratchArena<T>>&& arena)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        free_arenas.push_back(std::move(arena));
+    }
+
+    uint32_t som_size;
+    uint32_t number_of_spatial_transformations;
+    uint32_t neuron_size;
+    uint32_t window_stride;
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ScratchArena<T>>> free_arenas;
+};
+
+} // namespace pink
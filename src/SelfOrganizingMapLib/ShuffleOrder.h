@@ -0,0 +1,85 @@
+/**
+ * @file   SelfOrganizingMapLib/ShuffleOrder.h
+ * @brief  Random orders of data entries for the data iterators.
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace pink {
+
+/// Returns a random permutation of all entries
+inline std::vector<uint32_t> get_shuffled_order(uint32_t number_of_entries, uint64_t seed)
+{
+    std::vector<uint32_t> order(number_of_entries);
+    std::iota(std::begin(order), std::end(order), 0);
+
+    std::default_random_engine engine(seed);
+    std::mt19937 dist(engine());
+    std::shuffle(std::begin(order), std::end(order), dist);
+
+    return order;
+}
+
+/// Block shuffle: the entries are divided into contiguous blocks of block_size entries,
+/// whose order is permuted. Consecutive blocks of the permutation are collected in buffers
+/// of at least buffer_size entries and the entries are shuffled within each buffer.
+/// Therefore, the entries of a buffer can be read by a few sequential reads.
+/// The buffer boundaries are stored as positions in the order, ending with number_of_entries.
+/// A block size of zero returns @get_shuffled_order with a single buffer.
+inline std::vector<uint32_t> get_block_shuffled_order(uint32_t number_of_entries, uint32_t block_size,
+    uint32_t buffer_size, uint64_t seed, std::vector<uint32_t>& buffer_ends)
+{
+    if (block_size == 0) {
+        buffer_ends.assign(1, number_of_entries);
+        return get_shuffled_order(number_of_entries, seed);
+    }
+
+    uint32_t number_of_blocks = (number_of_entries + block_size - 1) / block_size;
+    uint32_t blocks_per_buffer = std::max(1U, (buffer_size + block_size - 1) / block_size);
+
+    std::vector<uint32_t> blocks(number_of_blocks);
+    std::iota(std::begin(blocks), std::end(blocks), 0);
+
+    std::default_random_engine engine(seed);
+    std::mt19937 dist(engine());
+    std::shuffle(std::begin(blocks), std::end(blocks), dist);
+
+    std::vector<uint32_t> order;
+    order.reserve(number_of_entries);
+    buffer_ends.clear();
+
+    for (uint32_t b = 0; b < number_of_blocks; b += blocks_per_buffer) {
+        auto&& buffer_begin = order.size();
+        for (uint32_t i = b; i < std::min(b + blocks_per_buffer, number_of_blocks); ++i) {
+            uint64_t block_begin = static_cast<uint64_t>(blocks[i]) * block_size;
+            uint64_t block_end = std::min(block_begin + block_size, static_cast<uint64_t>(number_of_entries));
+            for (uint64_t e = block_begin; e < block_end; ++e) order.push_back(e);
+        }
+        std::shuffle(std::begin(order) + buffer_begin, std::end(order), dist);
+        buffer_ends.push_back(order.size());
+    }
+
+    return order;
+}
+
+/// Returns the contiguous ranges (first entry, number of entries) of sorted unique entries
+inline std::vector<std::pair<uint32_t, uint32_t>> get_contiguous_ranges(std::vector<uint32_t> const& sorted_entries)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    for (auto&& e : sorted_entries) {
+        if (!ranges.empty() and ranges.back().first + ranges.back().second == e) ++ranges.back().second;
+        else ranges.emplace_back(e, 1);
+    }
+    return ranges;
+}
+
+} // namespace pink
@@ -7,18 +7,28 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <omp.h>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "Data.h"
+#include "DataView.h"
 #include "find_best_match.h"
 #include "generate_rotated_images.h"
 #include "generate_euclidean_distance_matrix.h"
+#include "generate_euclidean_distance_matrix_coarse_to_fine.h"
+#include "ScratchArena.h"
 #include "SOM.h"
 #include "SOMIO.h"
+#include "UtilitiesLib/AlignedAllocator.h"
+#include "UtilitiesLib/EuclideanDistanceBackend.h"
 #include "UtilitiesLib/Interpolation.h"
+#include "UtilitiesLib/PhaseTimer.h"
 #include "UtilitiesLib/pink_exception.h"
 
 #ifdef __CUDACC__
@@ -49,7 +59,7 @@ public:
        interpolation(interpolation),
        update_info(som.get_som_layout()),
        som_size(som.get_som_layout().size()),
-       update_factors(som_size * som_size, 0.0),
+       update_offsets(som_size + 1, 0),
        euclidean_distance_dim(euclidean_distance_dim)
     {
         if (number_of_rotations == 0 or (number_of_rotations != 1 and number_of_rotations % 4 != 0))
@@ -59,27 +69,76 @@ public:
             for (uint32_t j = 0; j < som_size; ++j) {
                 float distance = som.get_som_layout().get_distance(i, j);
                 if (this->max_update_distance <= 0 or distance < this->max_update_distance) {
-                    update_factors[i * som_size + j] = distribution_function(distance);
+                    float factor = distribution_function(distance);
+                    if (factor != 0.0) {
+                        update_neuron_indices.push_back(j);
+                        update_factors.push_back(factor);
+                    }
                 }
             }
+            update_offsets[i + 1] = update_neuron_indices.size();
         }
+        update_neuron_indices.shrink_to_fit();
+        update_factors.shrink_to_fit();
 
         if (euclidean_distance_dim == -1) {
-            euclidean_distance_dim = som.get_neuron_dimension()[0];
-            if (number_of_rotations != 1) euclidean_distance_dim *= std::sqrt(2.0) / 2.0;
+            this->euclidean_distance_dim = som.get_neuron_dimension()[0];
+            if (number_of_rotations != 1) this->euclidean_distance_dim *= std::sqrt(2.0) / 2.0;
         }
 
+        if (this->euclidean_distance_dim < 0 or this->euclidean_distance_dim > static_cast<int>(som.get_neuron_dimension()[0]))
+            throw pink::exception("Dimension of euclidean distance calculation must not be larger than the neuron dimension");
+
         if (verbosity)
             std::cout << "Number of rotations = " << number_of_rotations << "\n"
-                      << "Dimension of euclidean distance calculation = " << euclidean_distance_dim << std::endl;
+                      << "Dimension of euclidean distance calculation = " << this->euclidean_distance_dim << std::endl;
     }
 
-    auto get_update_info() const { return update_info; }
+    auto const& get_update_info() const { return update_info; }
+
+    /// Restores the number of updates of each neuron, e.g. from a checkpoint
+    void set_update_info(std::vector<uint32_t> const& number_of_updates)
+    {
+        if (number_of_updates.size() != update_info.size())
+            throw pink::exception("Number of neurons of the update information does not match");
+        std::copy(std::begin(number_of_updates), std::end(number_of_updates), update_info.get_data_pointer());
+    }
 
 protected:
 
     typedef Data<SOMLayout, uint32_t> UpdateInfoType;
 
+    /// Returns the dense som_size x som_size table of the updating factors
+    std::vector<float> get_dense_update_factors() const
+    {
+        std::vector<float> dense_update_factors(som_size * som_size, 0.0);
+        for (uint32_t i = 0; i < som_size; ++i) {
+            for (uint32_t k = update_offsets[i]; k < update_offsets[i + 1]; ++k) {
+                dense_update_factors[i * som_size + update_neuron_indices[k]] = update_factors[k];
+            }
+        }
+        return dense_update_factors;
+    }
+
+    /// Fill the cache of the centered euclidean distance windows for all neurons.
+    /// The windows are first touched by the packing threads.
+    void init_neuron_windows(T const *som_data, uint32_t neuron_dim)
+    {
+        uint32_t window_stride = get_window_stride<T>(euclidean_distance_dim);
+        neuron_windows.resize(static_cast<size_t>(som_size) * window_stride);
+        neuron_window_norms.resize(som_size);
+        pack_centered_windows(neuron_windows.data(), neuron_window_norms.data(), som_data, som_size,
+            neuron_dim, euclidean_distance_dim, window_stride);
+    }
+
+    /// Refresh the cached window of a single neuron after its update, the padding remains zero
+    void update_neuron_window(uint32_t i, T const *neuron, uint32_t neuron_dim)
+    {
+        uint32_t window_stride = get_window_stride<T>(euclidean_distance_dim);
+        neuron_window_norms[i] = pack_centered_window(&neuron_windows[static_cast<size_t>(i) * window_stride],
+            neuron, neuron_dim, euclidean_distance_dim);
+    }
+
     std::function<float(float)> distribution_function;
     int verbosity;
     uint32_t number_of_rotations;
@@ -95,11 +154,27 @@ protected:
     /// Number of neurons
     uint32_t som_size;
 
-    /// Pre-calculation of updating factors
+    /// Pre-calculation of the updating factors as compressed sparse rows. The neurons
+    /// update_neuron_indices[k] with the factors update_factors[k] for update_offsets[b] <= k < update_offsets[b+1]
+    /// are updated if neuron b is the best match. Neurons with a factor of zero are not stored.
+    std::vector<uint32_t> update_offsets;
+
+    /// Indices of the neurons to update
+    std::vector<uint32_t> update_neuron_indices;
+
+    /// Updating factors
     std::vector<float> update_factors;
 
     /// Dimension for calculation of euclidean distance
     int euclidean_distance_dim;
+
+    /// Contiguous copy of the centered euclidean distance window of each neuron,
+    /// only refreshed for updated neurons (CPU version only). Each window starts at a
+    /// cache line and is padded with zeros (see @get_window_stride).
+    AlignedVector<T> neuron_windows;
+
+    /// Squared norm of each neuron window
+    std::vector<T> neuron_window_norms;
 };
 
 /// Primary template will never be instantiated
@@ -108,6 +183,10 @@ class Trainer;
 
 
 /// CPU version of training
+///
+/// Each call leases its own scratch arenas. The spatial transformations can be prepared by
+/// transform() concurrently to the training, but the training calls themselves update the SOM
+/// and must not be called concurrently (see train_hogwild for the parallel online training).
 template <typename SOMLayout, typename DataLayout, typename T>
 class Trainer<SOMLayout, DataLayout, T, false> : public TrainerBase<SOMLayout, DataLayout, T>
 {
@@ -118,32 +197,310 @@ public:
 
     Trainer(SOMType& som, std::function<float(float)> distribution_function, int verbosity,
         uint32_t number_of_rotations, bool use_flip, float max_update_distance,
-        Interpolation interpolation, int euclidean_distance_dim = -1)
+        Interpolation interpolation, int euclidean_distance_dim = -1,
+        EuclideanDistanceBackend euclidean_distance_backend = EuclideanDistanceBackend::DIRECT,
+        uint32_t coarse_rotation_step = 1, uint32_t number_of_refinement_candidates = 2)
      : TrainerBase<SOMLayout, DataLayout, T>(som, distribution_function, verbosity, number_of_rotations,
            use_flip, max_update_distance, interpolation, euclidean_distance_dim),
-       som(som)
-    {}
+       som(som),
+       euclidean_distance_backend(euclidean_distance_backend),
+       coarse_rotation_step(coarse_rotation_step),
+       number_of_refinement_candidates(number_of_refinement_candidates),
+       scratch_arenas(this->som_size, this->number_of_spatial_transformations, som.get_neuron_size(),
+           get_window_stride<T>(this->euclidean_distance_dim)),
+       rotation_plans(som.get_neuron_dimension()[0], number_of_rotations, interpolation)
+    {
+        this->init_neuron_windows(som.get_data_pointer(), som.get_neuron_dimension()[0]);
+    }
+
+    /// Training the SOM by a single data point, the spatial transformations are
+    /// generated in a scratch arena leased by the calling thread
+    void operator () (DataView<DataLayout, T> const& data)
+    {
+        auto&& lease = scratch_arenas.acquire();
+        ScratchArena<T>& arena = *lease;
+        transform(data, arena.spatial_transformed_images);
+        train(data, arena.spatial_transformed_images, arena);
+    }
+
+    /// Returns the spatial transformations of a data point, which do not depend on the SOM
+    /// and can therefore be prepared in advance. For the coarse-to-fine search the
+    /// transformations are generated on demand and the result is empty.
+    std::vector<T> transform(DataView<DataLayout, T> const& data) const
+    {
+        if (coarse_rotation_step > 1 and this->number_of_rotations > 1) return std::vector<T>();
+        return generate_rotated_images(data, this->number_of_rotations,
+            this->use_flip, this->interpolation, som.get_neuron_dimension()[0],
+            rotation_plans.get(data.get_dimension()[0]));
+    }
+
+    /// Same as above, the spatial transformations are written into the given vector,
+    /// which is only resized if it is too small
+    void transform(DataView<DataLayout, T> const& data, std::vector<T>& spatial_transformed_images) const
+    {
+        if (coarse_rotation_step > 1 and this->number_of_rotations > 1) return;
+        size_t size = get_rotated_images_size(data, this->number_of_rotations, this->use_flip, som.get_neuron_dimension()[0]);
+        if (spatial_transformed_images.size() < size) spatial_transformed_images.resize(size);
+        generate_rotated_images(&spatial_transformed_images[0], data, this->number_of_rotations,
+            this->use_flip, this->interpolation, som.get_neuron_dimension()[0],
+            rotation_plans.get(data.get_dimension()[0]));
+    }
+
+    /// Training the SOM by a single data point with the spatial transformations prepared by transform()
+    void operator () (DataView<DataLayout, T> const& data, std::vector<T>& spatial_transformed_images)
+    {
+        auto&& lease = scratch_arenas.acquire();
+        train(data, spatial_transformed_images, *lease);
+    }
+
+    /// Hogwild-style parallel online training
+    ///
+    /// All threads take data points from the iterator and apply the online update of
+    /// operator()(Data) concurrently to the shared SOM without locks. Only the access to the
+    /// iterator and the update counter are synchronized. Concurrent updates of the same neuron
+    /// may get lost or mixed, which is accepted in favor of throughput (Niu et al., Hogwild!, 2011).
+    /// Therefore, the result is not reproducible for more than one thread.
+    /// The function step is called within the synchronized section after each data point is taken,
+    /// while the other threads continue to update the SOM.
+    ///
+    /// The GEMM backend is not supported, as it combines the cached neuron windows with their
+    /// separately cached norms. A concurrently rewritten window with a stale norm (or vice versa)
+    /// leads to wrong and even negative distances, not only to lost updates.
+    template <typename Iterator>
+    void train_hogwild(Iterator& iter_cur, Iterator const& iter_end, std::function<void()> const& step = [](){})
+    {
+        if (euclidean_distance_backend == EuclideanDistanceBackend::GEMM)
+            throw pink::exception("Hogwild training can not be combined with the GEMM backend of the euclidean distance.");
+
+        #pragma omp parallel
+        {
+            // Data views are taken directly, all others are copied
+            typename std::decay<decltype(*iter_cur)>::type data;
+            auto&& lease = scratch_arenas.acquire();
+            ScratchArena<T>& arena = *lease;
+
+            while (true)
+            {
+                bool valid;
+                #pragma omp critical (pink_trainer_hogwild)
+                {
+                    valid = iter_cur != iter_end;
+                    if (valid) {
+                        data = *iter_cur;
+                        ++iter_cur;
+                        step();
+                    }
+                }
+                if (!valid) break;
+
+                uint32_t best_match = calculate_best_match(data, arena.spatial_transformed_images, arena);
+
+                update_neighborhood(best_match, arena.spatial_transformed_images, arena.best_rotation_matrix);
+
+                uint32_t& number_of_updates = this->update_info[best_match];
+                #pragma omp atomic
+                ++number_of_updates;
+            }
+        }
+    }
+
+    /// Training the SOM by a batch of data points (batch SOM)
+    ///
+    /// The best matching neurons and spatial transformations of all data points are
+    /// calculated in parallel against the unchanged SOM. Afterwards, each neuron is moved
+    /// by the sum of the weighted differences sum_n f_n * (x_n - w) divided by max(1, sum_n |f_n|).
+    /// For a batch with a single data point this is the online update of operator()(Data),
+    /// as long as all updating factors satisfy |f| <= 1.
+    ///
+    /// Only the best match and the best transformations of its neighborhood are kept for each
+    /// data point. The update is then distributed over the neurons: each thread accumulates the
+    /// contributions of the data points to a neuron in data point order and regenerates the needed
+    /// spatial transformation on demand, so that no thread needs a buffer with the size of the SOM
+    /// and the result does not depend on the number of threads.
+    /// The batch can consist of data points or data views of two-dimensional images.
+    template <typename DataPointType>
+    void operator () (std::vector<DataPointType> const& batch)
+    {
+        if (batch.empty()) return;
+
+        uint32_t neuron_dim = som.get_neuron_dimension()[0];
+        uint32_t neuron_size = neuron_dim * neuron_dim;
+
+        for (auto&& data : batch) {
+            if (DataView<DataLayout, T>(data).get_layout().dimensionality != 2)
+                throw pink::exception("Batch training needs two-dimensional data.");
+        }
+
+        // Largest neighborhood is the stride of the best transformations of each data point
+        uint32_t neighborhood_stride = 0;
+        for (uint32_t b = 0; b < this->som_size; ++b) {
+            neighborhood_stride = std::max(neighborhood_stride, this->update_offsets[b + 1] - this->update_offsets[b]);
+        }
+
+        batch_best_matches.resize(batch.size());
+        batch_rotation_plans.resize(batch.size());
+        batch_transformations.resize(batch.size() * neighborhood_stride);
+
+        int number_of_threads = std::max(1, std::min(omp_get_max_threads(), static_cast<int>(batch.size())));
+        #pragma omp parallel num_threads(number_of_threads)
+        {
+            auto&& lease = scratch_arenas.acquire();
+            ScratchArena<T>& arena = *lease;
+
+            #pragma omp for schedule(static)
+            for (int n = 0; n < static_cast<int>(batch.size()); ++n)
+            {
+                DataView<DataLayout, T> data(batch[n]);
+                uint32_t best_match = calculate_best_match(data, arena.spatial_transformed_images, arena);
+                batch_best_matches[n] = best_match;
+                batch_rotation_plans[n] = rotation_plans.get(data.get_dimension()[0]);
+
+                uint32_t *transformations = &batch_transformations[n * neighborhood_stride];
+                for (uint32_t k = this->update_offsets[best_match]; k < this->update_offsets[best_match + 1]; ++k) {
+                    *transformations++ = arena.best_rotation_matrix[this->update_neuron_indices[k]];
+                }
+            }
+        }
+
+        ScopedPhaseTimer timer(Phase::UPDATE);
 
-    void operator () (Data<DataLayout, T> const& data)
+        // Contributions (data point, index of the updating factor) to each neuron as compressed sparse rows
+        contribution_offsets.assign(this->som_size + 1, 0);
+        for (auto&& best_match : batch_best_matches) {
+            for (uint32_t k = this->update_offsets[best_match]; k < this->update_offsets[best_match + 1]; ++k) {
+                ++contribution_offsets[this->update_neuron_indices[k] + 1];
+            }
+        }
+        for (uint32_t i = 0; i < this->som_size; ++i) contribution_offsets[i + 1] += contribution_offsets[i];
+
+        contributions.resize(contribution_offsets[this->som_size]);
+        contribution_positions.assign(contribution_offsets.begin(), contribution_offsets.end() - 1);
+        for (uint32_t n = 0; n < batch.size(); ++n) {
+            uint32_t best_match = batch_best_matches[n];
+            for (uint32_t k = this->update_offsets[best_match]; k < this->update_offsets[best_match + 1]; ++k) {
+                contributions[contribution_positions[this->update_neuron_indices[k]]++] = std::make_pair(n, k);
+            }
+        }
+
+        #pragma omp parallel
+        {
+            auto&& lease = scratch_arenas.acquire();
+            ScratchArena<T>& arena = *lease;
+            T *update = &arena.neuron_buffers[0];
+            T *image = update + neuron_size;
+            T *buffer = image + neuron_size;
+
+            #pragma omp for schedule(dynamic)
+            for (int i = 0; i < static_cast<int>(this->som_size); ++i)
+            {
+                if (contribution_offsets[i] == contribution_offsets[i + 1]) continue;
+
+                T *current_neuron = som.get_data_pointer() + static_cast<size_t>(i) * neuron_size;
+                std::fill(update, update + neuron_size, T(0));
+                float weight = 0.0;
+
+                for (uint32_t c = contribution_offsets[i]; c < contribution_offsets[i + 1]; ++c) {
+                    uint32_t n = contributions[c].first;
+                    uint32_t k = contributions[c].second;
+                    uint32_t best_match = batch_best_matches[n];
+                    uint32_t transformation = batch_transformations[n * neighborhood_stride + k - this->update_offsets[best_match]];
+                    float factor = this->update_factors[k];
+
+                    DataView<DataLayout, T> data(batch[n]);
+                    generate_rotated_image(image, data.get_data_pointer(), data.get_dimension()[0], neuron_dim,
+                        this->number_of_rotations, transformation, this->interpolation, buffer, batch_rotation_plans[n]);
+
+                    for (uint32_t j = 0; j < neuron_size; ++j) {
+                        update[j] += (image[j] - current_neuron[j]) * factor;
+                    }
+                    weight += std::abs(factor);
+                }
+
+                weight = std::max(1.0f, weight);
+                for (uint32_t j = 0; j < neuron_size; ++j) current_neuron[j] += update[j] / weight;
+                this->update_neuron_window(i, current_neuron, neuron_dim);
+            }
+        }
+
+        for (auto&& best_match : batch_best_matches) ++this->update_info[best_match];
+    }
+
+private:
+
+    /// Online update of a single data point with prepared spatial transformations
+    void train(DataView<DataLayout, T> const& data, std::vector<T>& spatial_transformed_images, ScratchArena<T>& arena)
+    {
+        uint32_t best_match = calculate_best_match(data, spatial_transformed_images, arena, true);
+
+        update_neighborhood(best_match, spatial_transformed_images, arena.best_rotation_matrix);
+
+        ++this->update_info[best_match];
+    }
+
+    /// Move all neurons in the neighborhood of the best match towards the best spatial transformation
+    void update_neighborhood(uint32_t best_match, std::vector<T> const& spatial_transformed_images,
+        std::vector<uint32_t> const& best_rotation_matrix)
     {
+        ScopedPhaseTimer timer(Phase::UPDATE);
+
         uint32_t neuron_dim = som.get_neuron_dimension()[0];
         uint32_t neuron_size = neuron_dim * neuron_dim;
 
-        // Memory allocation
-        std::vector<T> euclidean_distance_matrix(this->som.get_number_of_neurons());
-        std::vector<uint32_t> best_rotation_matrix(this->som.get_number_of_neurons());
+        for (uint32_t k = this->update_offsets[best_match]; k < this->update_offsets[best_match + 1]; ++k) {
+            uint32_t i = this->update_neuron_indices[k];
+            float factor = this->update_factors[k];
+            T *current_neuron = som.get_data_pointer() + i * neuron_size;
+            T const *current_image = &spatial_transformed_images[best_rotation_matrix[i] * neuron_size];
+            for (uint32_t j = 0; j < neuron_size; ++j) {
+                current_neuron[j] -= (current_neuron[j] - current_image[j]) * factor;
+            }
+            this->update_neuron_window(i, current_neuron, neuron_dim);
+        }
+    }
 
-        auto&& spatial_transformed_images = generate_rotated_images(data, this->number_of_rotations,
-            this->use_flip, this->interpolation, neuron_dim);
+    /// Returns the best matching neuron of a single data point. The spatial transformed images are
+    /// stored in the given vector, the packed image windows, the euclidean distances, and the best
+    /// transformation of each neuron are stored in the scratch arena.
+    /// If transformed is true, the spatial transformed images are already prepared by transform().
+    uint32_t calculate_best_match(DataView<DataLayout, T> const& data, std::vector<T>& spatial_transformed_images,
+        ScratchArena<T>& arena, bool transformed = false) const
+    {
+        uint32_t neuron_dim = som.get_neuron_dimension()[0];
+        auto&& euclidean_distance_matrix = arena.euclidean_distance_matrix;
+        auto&& best_rotation_matrix = arena.best_rotation_matrix;
+
+        if (coarse_rotation_step > 1 and this->number_of_rotations > 1) {
+            if (data.get_layout().dimensionality != 2) throw pink::exception("Coarse-to-fine rotation search needs two-dimensional data.");
+            generate_euclidean_distance_matrix_coarse_to_fine(euclidean_distance_matrix, best_rotation_matrix,
+                this->som_size, this->neuron_windows.data(), data.get_data_pointer(), data.get_dimension()[0],
+                neuron_dim, this->number_of_rotations, this->use_flip, this->interpolation, this->euclidean_distance_dim,
+                coarse_rotation_step, number_of_refinement_candidates, spatial_transformed_images,
+                arena.image_windows, get_window_stride<T>(this->euclidean_distance_dim),
+                rotation_plans.get(data.get_dimension()[0]));
+            return find_best_match(euclidean_distance_matrix, this->som_size);
+        }
+
+        if (!transformed) transform(data, spatial_transformed_images);
 
 #ifdef PRINT_DEBUG
         for (auto&& e : spatial_transformed_images) std::cout << e << " ";
         std::cout << std::endl;
 #endif
 
-        generate_euclidean_distance_matrix(euclidean_distance_matrix, best_rotation_matrix,
-            this->som.get_number_of_neurons(), som.get_data_pointer(), neuron_dim, this->number_of_spatial_transformations,
-            spatial_transformed_images, this->euclidean_distance_dim);
+        {
+            // The neurons are taken from the cache, only the transformed images must be packed.
+            // The zero padding of the aligned windows does not change the distances.
+            ScopedPhaseTimer timer(Phase::DISTANCE);
+            uint32_t window_stride = get_window_stride<T>(this->euclidean_distance_dim);
+            pack_centered_windows(arena.image_windows.data(), arena.image_window_norms.data(),
+                spatial_transformed_images.data(), this->number_of_spatial_transformations, neuron_dim,
+                this->euclidean_distance_dim, window_stride);
+
+            generate_euclidean_distance_matrix_packed(euclidean_distance_matrix, best_rotation_matrix,
+                this->som_size, this->neuron_windows.data(), this->neuron_window_norms.data(),
+                this->number_of_spatial_transformations, arena.image_windows.data(), arena.image_window_norms.data(),
+                window_stride, euclidean_distance_backend, arena.dot_products);
+        }
 
 #ifdef PRINT_DEBUG
         std::cout << "euclidean_distance_matrix" << std::endl;
@@ -156,28 +513,40 @@ public:
 #endif
 
         /// Find the best matching neuron, with the lowest euclidean distance
-        auto&& best_match = std::distance(euclidean_distance_matrix.begin(),
-            std::min_element(std::begin(euclidean_distance_matrix), std::end(euclidean_distance_matrix)));
-
-        auto&& current_neuron = som.get_data_pointer();
-        for (uint32_t i = 0; i < this->som.get_number_of_neurons(); ++i) {
-            float factor = this->update_factors[best_match * this->som.get_number_of_neurons() + i];
-            if (factor != 0.0) {
-                T *current_image = &spatial_transformed_images[best_rotation_matrix[i] * neuron_size];
-                for (uint32_t j = 0; j < neuron_size; ++j) {
-                    current_neuron[j] -= (current_neuron[j] - current_image[j]) * factor;
-                }
-            }
-            current_neuron += neuron_size;
-        }
-
-        ++this->update_info[best_match];
+        return find_best_match(euclidean_distance_matrix, this->som_size);
     }
 
-private:
-
     /// A reference to the SOM will be trained
     SOMType& som;
+
+    /// Algorithm for the calculation of the euclidean distance matrix
+    EuclideanDistanceBackend euclidean_distance_backend;
+
+    /// Angle step of the coarse rotation search (1 = exhaustive search)
+    uint32_t coarse_rotation_step;
+
+    /// Number of coarse transformations per neuron which are refined
+    uint32_t number_of_refinement_candidates;
+
+    /// Reusable buffers of the best match search, leased by each training thread
+    ScratchArenas<T> scratch_arenas;
+
+    /// Bilinear rotation plans of the spatial transformations
+    BilinearRotationPlanCache rotation_plans;
+
+    /// Best match of each data point of the last batch
+    std::vector<uint32_t> batch_best_matches;
+
+    /// Bilinear rotation plans of each data point of the last batch
+    std::vector<BilinearRotationPlans const*> batch_rotation_plans;
+
+    /// Best transformations of the neighborhood of the best match of each data point of the last batch
+    std::vector<uint32_t> batch_transformations;
+
+    /// Contributions of the data points of the last batch to each neuron, see operator()(batch)
+    std::vector<uint32_t> contribution_offsets;
+    std::vector<uint32_t> contribution_positions;
+    std::vector<std::pair<uint32_t, uint32_t>> contributions;
 };
 
 
@@ -223,22 +592,25 @@ public:
             d_sin_alpha = sin_alpha;
         }
 
-        d_update_factors = this->update_factors;
+        d_update_factors = this->get_dense_update_factors();
     }
 
     /// Training the SOM by a single data point
-    void operator () (Data<DataLayout, T> const& data)
+    void operator () (DataView<DataLayout, T> const& data)
     {
-        /// Device memory for data
-        thrust::device_vector<T> d_data = data.get_data();
+        /// Device memory for data, copied directly from the view
+        thrust::device_vector<T> d_data(data.get_data_pointer(), data.get_data_pointer() + data.size());
 
         uint32_t neuron_dim = som.get_neuron_dimension()[0];
         uint32_t neuron_size = neuron_dim * neuron_dim;
         uint32_t spacing = data.get_layout().dimensionality > 2 ? data.get_dimension()[2] : 1;
         for (uint32_t i = 3; i < data.get_layout().dimensionality; ++i) spacing *= data.get_dimension()[i];
 
-        generate_rotated_images(d_spatial_transformed_images, d_data, spacing, this->number_of_rotations,
-            data.get_dimension()[0], neuron_dim, this->use_flip, this->interpolation, d_cos_alpha, d_sin_alpha);
+        {
+            ScopedPhaseTimer timer(Phase::ROTATION);
+            generate_rotated_images(d_spatial_transformed_images, d_data, spacing, this->number_of_rotations,
+                data.get_dimension()[0], neuron_dim, this->use_flip, this->interpolation, d_cos_alpha, d_sin_alpha);
+        }
 
 #ifdef PRINT_DEBUG
         thrust::host_vector<T> spatial_transformed_images = d_spatial_transformed_images;
@@ -246,9 +618,12 @@ public:
         std::cout << std::endl;
 #endif
 
-        generate_euclidean_distance_matrix(d_euclidean_distance_matrix, d_best_rotation_matrix,
-            this->som.get_number_of_neurons(), neuron_size, d_som, this->number_of_spatial_transformations,
-            d_spatial_transformed_images, block_size, euclidean_distance_type, this->euclidean_distance_dim);
+        {
+            ScopedPhaseTimer timer(Phase::DISTANCE);
+            generate_euclidean_distance_matrix(d_euclidean_distance_matrix, d_best_rotation_matrix,
+                this->som.get_number_of_neurons(), neuron_size, d_som, this->number_of_spatial_transformations,
+                d_spatial_transformed_images, block_size, euclidean_distance_type, this->euclidean_distance_dim);
+        }
 
 #ifdef PRINT_DEBUG
         std::cout << "euclidean_distance_matrix" << std::endl;
@@ -262,6 +637,8 @@ public:
         std::cout << std::endl;
 #endif
 
+        // The best match is searched on the device by the update kernel
+        ScopedPhaseTimer timer(Phase::UPDATE);
         update_neurons(d_som, d_spatial_transformed_images, d_best_rotation_matrix, d_euclidean_distance_matrix,
             d_best_match, d_update_factors, this->som.get_number_of_neurons(), neuron_size);
 
@@ -269,6 +646,32 @@ public:
         ++this->update_info[best_match[0]];
     }
 
+    /// The spatial transformations are generated on the device, the result is empty
+    std::vector<T> transform(DataView<DataLayout, T> const&) const
+    {
+        return std::vector<T>();
+    }
+
+    /// Training the SOM by a single data point, see transform()
+    void operator () (DataView<DataLayout, T> const& data, std::vector<T>&)
+    {
+        operator()(data);
+    }
+
+    /// Batch training is only supported by the CPU version
+    template <typename DataPointType>
+    void operator () (std::vector<DataPointType> const&)
+    {
+        throw pink::exception("Batch training is only supported by the CPU version");
+    }
+
+    /// Hogwild training is only supported by the CPU version
+    template <typename Iterator>
+    void train_hogwild(Iterator&, Iterator const&, std::function<void()> const& = [](){})
+    {
+        throw pink::exception("Hogwild training is only supported by the CPU version");
+    }
+
     void update_som()
     {
         thrust::copy(d_som.begin(), d_som.end(), som.get_data_pointer());
@@ -6,14 +6,20 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <numeric>
 #include <vector>
 
+#include "UtilitiesLib/PhaseTimer.h"
+
 namespace pink {
 
 template <typename T>
 uint32_t find_best_match(std::vector<T> const& euclidean_distance_matrix, uint32_t som_size)
 {
+    ScopedPhaseTimer timer(Phase::BEST_MATCH);
+
     uint32_t best_match = 0;
     T min_distance = euclidean_distance_matrix[0];
     for (uint32_t i = 1; i < som_size; ++i) {
@@ -25,4 +31,25 @@ uint32_t find_best_match(std::vector<T> const& euclidean_distance_matrix, uint32
     return best_match;
 }
 
+/// Returns the k best matching neurons sorted by the euclidean distance by a partial selection.
+/// Neurons with equal distances are sorted by their index, so the first one is @find_best_match.
+template <typename T>
+std::vector<uint32_t> find_best_matches(std::vector<T> const& euclidean_distance_matrix, uint32_t som_size, uint32_t k)
+{
+    ScopedPhaseTimer timer(Phase::BEST_MATCH);
+
+    std::vector<uint32_t> neurons(som_size);
+    std::iota(std::begin(neurons), std::end(neurons), 0);
+    k = std::min(k, som_size);
+
+    std::partial_sort(std::begin(neurons), std::begin(neurons) + k, std::end(neurons),
+        [&](uint32_t a, uint32_t b) {
+            return euclidean_distance_matrix[a] < euclidean_distance_matrix[b]
+                or (euclidean_distance_matrix[a] == euclidean_distance_matrix[b] and a < b);
+        });
+
+    neurons.resize(k);
+    return neurons;
+}
+
 } // namespace pink
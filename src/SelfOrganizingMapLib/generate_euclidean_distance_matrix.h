@@ -6,38 +6,231 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <omp.h>
 #include <vector>
 
 #include "ImageProcessingLib/euclidean_distance.h"
+#include "ImageProcessingLib/gemm.h"
+#include "UtilitiesLib/AlignedAllocator.h"
+#include "UtilitiesLib/EuclideanDistanceBackend.h"
+#include "UtilitiesLib/PhaseTimer.h"
 
 namespace pink {
 
+/// Calculates for each neuron the minimal distance over all spatial transformations
+/// and the index of the corresponding transformation. The distance of neuron i and
+/// transformation j is given by the functor distance(i, j).
+///
+/// The complete (neuron, transformation) space is distributed over the threads in a single
+/// parallel region. Each thread keeps its own minimum and argmin per neuron, which are reduced
+/// afterwards. For equal distances the lowest transformation index wins, so the result is
+/// independent of the number of threads.
+template <typename T, typename DistanceFunctor>
+void reduce_euclidean_distance_matrix(std::vector<T>& euclidean_distance_matrix,
+    std::vector<uint32_t>& best_rotation_matrix, uint32_t som_size, uint32_t num_rot, DistanceFunctor distance)
+{
+    int64_t total_size = static_cast<int64_t>(som_size) * num_rot;
+
+    // Avoid oversized thread-local buffers if already called within a parallel region
+    int number_of_threads = omp_in_parallel() ? 1 : std::max<int64_t>(1, std::min<int64_t>(omp_get_max_threads(), total_size));
+    std::vector<T> thread_distance(number_of_threads * som_size, std::numeric_limits<T>::max());
+    std::vector<uint32_t> thread_rotation(number_of_threads * som_size, num_rot);
+
+    #pragma omp parallel num_threads(number_of_threads)
+    {
+        T *pdist = &thread_distance[omp_get_thread_num() * som_size];
+        uint32_t *prot = &thread_rotation[omp_get_thread_num() * som_size];
+
+        #pragma omp for schedule(static)
+        for (int64_t k = 0; k < total_size; ++k) {
+            uint32_t i = k / num_rot;
+            uint32_t j = k % num_rot;
+            T tmp = distance(i, j);
+            if (tmp < pdist[i]) {
+                pdist[i] = tmp;
+                prot[i] = j;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < som_size; ++i) {
+        euclidean_distance_matrix[i] = thread_distance[i];
+        best_rotation_matrix[i] = thread_rotation[i];
+        for (int t = 1; t < number_of_threads; ++t) {
+            T tmp = thread_distance[t * som_size + i];
+            uint32_t rot = thread_rotation[t * som_size + i];
+            if (tmp < euclidean_distance_matrix[i] or (tmp == euclidean_distance_matrix[i] and rot < best_rotation_matrix[i])) {
+                euclidean_distance_matrix[i] = tmp;
+                best_rotation_matrix[i] = rot;
+            }
+        }
+    }
+}
+
+/// Calculates for each neuron the minimal euclidean distance over all spatial transformations
+/// and the index of the corresponding transformation. Only the centered window with dimension
+/// euclidean_distance_dim of the neurons and images is taken into account.
 template <typename T>
-void generate_euclidean_distance_matrix(std::vector<T>& euclidean_distance_matrix,
+void generate_euclidean_distance_matrix_direct(std::vector<T>& euclidean_distance_matrix,
     std::vector<uint32_t>& best_rotation_matrix, uint32_t som_size, T const *som,
     uint32_t image_dim, uint32_t num_rot, std::vector<T> const& rotated_images, uint32_t euclidean_distance_dim)
 {
-    T tmp;
-    T* pdist = &euclidean_distance_matrix[0];
-    uint32_t* prot = &best_rotation_matrix[0];
+    uint32_t image_size = image_dim * image_dim;
+    T const *images = &rotated_images[0];
+
+    reduce_euclidean_distance_matrix(euclidean_distance_matrix, best_rotation_matrix, som_size, num_rot,
+        [=](uint32_t i, uint32_t j) {
+            return euclidean_distance_square_offset(som + i * image_size, images + j * image_size,
+                image_dim, euclidean_distance_dim);
+        });
+}
+
+/// Same as @generate_euclidean_distance_matrix_direct for windows already packed
+/// into contiguous rows of length window_size (see @pack_centered_windows)
+template <typename T>
+void generate_euclidean_distance_matrix_direct_packed(std::vector<T>& euclidean_distance_matrix,
+    std::vector<uint32_t>& best_rotation_matrix, uint32_t som_size, T const *packed_som,
+    uint32_t num_rot, T const *packed_images, uint32_t window_size)
+{
+    reduce_euclidean_distance_matrix(euclidean_distance_matrix, best_rotation_matrix, som_size, num_rot,
+        [=](uint32_t i, uint32_t j) {
+            return euclidean_distance_square(packed_som + static_cast<size_t>(i) * window_size,
+                packed_images + static_cast<size_t>(j) * window_size, window_size);
+        });
+}
+
+/// Copies the centered window with dimension euclidean_distance_dim of a single image
+/// into the contiguous array packed_image and returns the squared norm of the window
+template <typename T>
+T pack_centered_window(T *packed_image, T const *image, uint32_t image_dim, uint32_t euclidean_distance_dim)
+{
+    uint32_t offset = (image_dim - euclidean_distance_dim) / 2;
+    T const *src = image + offset * image_dim + offset;
+    for (uint32_t i = 0; i < euclidean_distance_dim; ++i) {
+        std::copy(src + i * image_dim, src + i * image_dim + euclidean_distance_dim, packed_image + i * euclidean_distance_dim);
+    }
+    return dot(packed_image, euclidean_distance_dim * euclidean_distance_dim);
+}
+
+/// Returns the number of elements of a packed window padded to full cache lines
+template <typename T>
+uint32_t get_window_stride(uint32_t euclidean_distance_dim)
+{
+    return get_padded_size<T>(euclidean_distance_dim * euclidean_distance_dim);
+}
 
+/// Copies the centered window with dimension euclidean_distance_dim of each image
+/// into a row of packed_images and stores the squared norm of each window.
+/// The rows have the distance window_stride, which is by default the window size.
+/// The padding behind each window is set to zero, so that the padded rows can be used
+/// for the distance calculation (see @get_window_stride).
+template <typename T>
+void pack_centered_windows(T *packed_images, T *norms, T const *images, uint32_t number_of_images,
+    uint32_t image_dim, uint32_t euclidean_distance_dim, uint32_t window_stride = 0)
+{
     uint32_t image_size = image_dim * image_dim;
+    uint32_t window_size = euclidean_distance_dim * euclidean_distance_dim;
+    if (window_stride == 0) window_stride = window_size;
+
+    #pragma omp parallel for
+    for (uint32_t n = 0; n < number_of_images; ++n) {
+        T *packed_image = packed_images + static_cast<size_t>(n) * window_stride;
+        norms[n] = pack_centered_window(packed_image, images + static_cast<size_t>(n) * image_size,
+            image_dim, euclidean_distance_dim);
+        std::fill(packed_image + window_size, packed_image + window_stride, T(0));
+    }
+}
 
-    for (uint32_t i = 0; i < som_size; ++i) euclidean_distance_matrix[i] = std::numeric_limits<T>::max();
+/// Euclidean distance matrix of packed windows using ||a - b||^2 = ||a||^2 + ||b||^2 - 2 a*b.
+/// All dot products are calculated by a single matrix multiplication into the buffer dot_products,
+/// which is only resized if it is too small.
+template <typename T>
+void generate_euclidean_distance_matrix_gemm_packed(std::vector<T>& euclidean_distance_matrix,
+    std::vector<uint32_t>& best_rotation_matrix, uint32_t som_size, T const *packed_som, T const *som_norms,
+    uint32_t num_rot, T const *packed_images, T const *image_norms, uint32_t window_size, std::vector<T>& dot_products)
+{
+    if (dot_products.size() < static_cast<size_t>(som_size) * num_rot) dot_products.resize(static_cast<size_t>(som_size) * num_rot);
+    gemm_nt(packed_som, packed_images, &dot_products[0], som_size, num_rot, window_size);
 
-    for (uint32_t i = 0; i < som_size; ++i, ++pdist, ++prot) {
-        #pragma omp parallel for private(tmp)
+    #pragma omp parallel for
+    for (uint32_t i = 0; i < som_size; ++i) {
+        T const *pdot = &dot_products[static_cast<size_t>(i) * num_rot];
+        T min_distance = std::numeric_limits<T>::max();
+        uint32_t best_rotation = 0;
         for (uint32_t j = 0; j < num_rot; ++j) {
-            tmp = euclidean_distance_square_offset(&som[i * image_size], &rotated_images[j * image_size], image_dim, euclidean_distance_dim);
-            #pragma omp critical
-            if (tmp < *pdist) {
-                *pdist = tmp;
-                *prot = j;
+            T tmp = image_norms[j] - 2 * pdot[j];
+            if (tmp < min_distance) {
+                min_distance = tmp;
+                best_rotation = j;
             }
         }
+        // Cancellation can lead to small negative values
+        euclidean_distance_matrix[i] = std::max(T(0), som_norms[i] + min_distance);
+        best_rotation_matrix[i] = best_rotation;
     }
 }
 
+/// Same as @generate_euclidean_distance_matrix_direct using the GEMM backend.
+/// The centered windows of the neurons and of the rotated images are packed first
+/// into aligned rows padded with zeros.
+template <typename T>
+void generate_euclidean_distance_matrix_gemm(std::vector<T>& euclidean_distance_matrix,
+    std::vector<uint32_t>& best_rotation_matrix, uint32_t som_size, T const *som,
+    uint32_t image_dim, uint32_t num_rot, std::vector<T> const& rotated_images, uint32_t euclidean_distance_dim)
+{
+    uint32_t window_size = get_window_stride<T>(euclidean_distance_dim);
+
+    AlignedVector<T> packed_som(static_cast<size_t>(som_size) * window_size);
+    std::vector<T> som_norms(som_size);
+    pack_centered_windows(&packed_som[0], &som_norms[0], som, som_size, image_dim, euclidean_distance_dim, window_size);
+
+    AlignedVector<T> packed_images(static_cast<size_t>(num_rot) * window_size);
+    std::vector<T> image_norms(num_rot);
+    pack_centered_windows(&packed_images[0], &image_norms[0], &rotated_images[0], num_rot, image_dim,
+        euclidean_distance_dim, window_size);
+
+    std::vector<T> dot_products;
+    generate_euclidean_distance_matrix_gemm_packed(euclidean_distance_matrix, best_rotation_matrix, som_size,
+        &packed_som[0], &som_norms[0], num_rot, &packed_images[0], &image_norms[0], window_size, dot_products);
+}
+
+/// Calculates the euclidean distance matrix of packed windows using the selected backend.
+/// The norms and the buffer of the dot products are only needed for the GEMM backend.
+template <typename T>
+void generate_euclidean_distance_matrix_packed(std::vector<T>& euclidean_distance_matrix,
+    std::vector<uint32_t>& best_rotation_matrix, uint32_t som_size, T const *packed_som, T const *som_norms,
+    uint32_t num_rot, T const *packed_images, T const *image_norms, uint32_t window_size,
+    EuclideanDistanceBackend backend, std::vector<T>& dot_products)
+{
+    ScopedPhaseTimer timer(Phase::DISTANCE);
+
+    if (backend == EuclideanDistanceBackend::GEMM)
+        generate_euclidean_distance_matrix_gemm_packed(euclidean_distance_matrix, best_rotation_matrix, som_size,
+            packed_som, som_norms, num_rot, packed_images, image_norms, window_size, dot_products);
+    else
+        generate_euclidean_distance_matrix_direct_packed(euclidean_distance_matrix, best_rotation_matrix, som_size,
+            packed_som, num_rot, packed_images, window_size);
+}
+
+/// Calculates for each neuron the minimal euclidean distance over all spatial transformations
+/// and the index of the corresponding transformation using the selected backend.
+template <typename T>
+void generate_euclidean_distance_matrix(std::vector<T>& euclidean_distance_matrix,
+    std::vector<uint32_t>& best_rotation_matrix, uint32_t som_size, T const *som,
+    uint32_t image_dim, uint32_t num_rot, std::vector<T> const& rotated_images, uint32_t euclidean_distance_dim,
+    EuclideanDistanceBackend backend = EuclideanDistanceBackend::DIRECT)
+{
+    ScopedPhaseTimer timer(Phase::DISTANCE);
+
+    if (backend == EuclideanDistanceBackend::GEMM)
+        generate_euclidean_distance_matrix_gemm(euclidean_distance_matrix, best_rotation_matrix, som_size, som,
+            image_dim, num_rot, rotated_images, euclidean_distance_dim);
+    else
+        generate_euclidean_distance_matrix_direct(euclidean_distance_matrix, best_rotation_matrix, som_size, som,
+            image_dim, num_rot, rotated_images, euclidean_distance_dim);
+}
+
 } // namespace pink
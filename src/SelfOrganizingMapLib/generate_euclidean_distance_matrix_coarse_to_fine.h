@@ -0,0 +1,183 @@
+/**
+ * @file   SelfOrganizingMapLib/generate_euclidean_distance_matrix_coarse_to_fine.h
+ * @brief  Hierarchical search of the best spatial transformation of each neuron.
+ *
+ * Instead of evaluating all rotation angles, only every coarse_rotation_step-th angle
+ * (and its flipped counterpart) is evaluated first. For each neuron the number_of_candidates
+ * best coarse transformations are then refined by evaluating all angles up to the
+ * neighboring coarse angles. The spatial transformations are generated on demand.
+ *
+ * The result is exact if the best transformation of a neuron lies within one coarse step
+ * of one of its candidates. The accuracy can be increased by a smaller coarse step or
+ * more candidates. A coarse step of one is the exhaustive search.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "generate_euclidean_distance_matrix.h"
+#include "generate_rotated_images.h"
+#include "ImageProcessingLib/euclidean_distance.h"
+#include "UtilitiesLib/AlignedAllocator.h"
+#include "UtilitiesLib/Interpolation.h"
+#include "UtilitiesLib/PhaseTimer.h"
+
+namespace pink {
+
+/// Generates the given spatial transformations of the image and packs their centered windows
+/// into the rows of packed_images with the distance window_stride
+template <typename T>
+void generate_spatial_transformations_on_demand(std::vector<T>& spatial_transformed_images,
+    AlignedVector<T>& packed_images, std::vector<uint32_t> const& transformations, T const *image,
+    uint32_t image_dim, uint32_t neuron_dim, uint32_t number_of_rotations, Interpolation interpolation,
+    uint32_t euclidean_distance_dim, uint32_t window_stride, BilinearRotationPlans const *plans)
+{
+    ScopedPhaseTimer timer(Phase::ROTATION);
+
+    size_t neuron_size = neuron_dim * neuron_dim;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < static_cast<int>(transformations.size()); ++k) {
+        uint32_t t = transformations[k];
+        generate_rotated_image(&spatial_transformed_images[t * neuron_size], image, image_dim, neuron_dim,
+            number_of_rotations, t, interpolation, plans);
+        pack_centered_window(&packed_images[t * window_stride], &spatial_transformed_images[t * neuron_size],
+            neuron_dim, euclidean_distance_dim);
+    }
+}
+
+/// Calculates for each neuron the minimal euclidean distance and the corresponding spatial
+/// transformation using the coarse-to-fine search. The centered windows of the neurons must
+/// be packed (see @pack_centered_windows) with the distance som_window_stride, which is by
+/// default the window size. The optional bilinear rotation plans are used as in
+/// @generate_rotated_images. Only the evaluated spatial transformations are
+/// valid in spatial_transformed_images, which includes the best transformations of all neurons.
+/// The packed windows of the spatial transformations are stored in packed_images. Both vectors
+/// are only resized if they are too small, so that they can be reused for the next image.
+template <typename T>
+void generate_euclidean_distance_matrix_coarse_to_fine(std::vector<T>& euclidean_distance_matrix,
+    std::vector<uint32_t>& best_rotation_matrix, uint32_t som_size, T const *packed_som,
+    T const *image, uint32_t image_dim, uint32_t neuron_dim, uint32_t number_of_rotations, bool use_flip,
+    Interpolation interpolation, uint32_t euclidean_distance_dim, uint32_t coarse_rotation_step,
+    uint32_t number_of_candidates, std::vector<T>& spatial_transformed_images, AlignedVector<T>& packed_images,
+    uint32_t som_window_stride = 0, BilinearRotationPlans const *plans = nullptr)
+{
+    uint32_t number_of_spatial_transformations = number_of_rotations * (use_flip ? 2 : 1);
+    uint32_t step = std::max(1U, std::min(coarse_rotation_step, number_of_rotations));
+    size_t window_size = euclidean_distance_dim * euclidean_distance_dim;
+    size_t image_window_stride = get_window_stride<T>(euclidean_distance_dim);
+    if (som_window_stride == 0) som_window_stride = window_size;
+
+    size_t images_size = static_cast<size_t>(number_of_spatial_transformations) * neuron_dim * neuron_dim;
+    if (spatial_transformed_images.size() < images_size) spatial_transformed_images.resize(images_size);
+    size_t packed_images_size = number_of_spatial_transformations * image_window_stride;
+    if (packed_images.size() < packed_images_size) packed_images.resize(packed_images_size);
+
+    std::vector<char> generated(number_of_spatial_transformations, 0);
+
+    auto&& distance = [&](uint32_t i, uint32_t t) {
+        return euclidean_distance_square(packed_som + static_cast<size_t>(i) * som_window_stride,
+            &packed_images[t * image_window_stride], window_size);
+    };
+
+    // Coarse grid
+    std::vector<uint32_t> coarse_transformations;
+    for (uint32_t t = 0; t < number_of_spatial_transformations; ++t) {
+        if (t % number_of_rotations % step == 0) {
+            coarse_transformations.push_back(t);
+            generated[t] = 1;
+        }
+    }
+    generate_spatial_transformations_on_demand(spatial_transformed_images, packed_images, coarse_transformations,
+        image, image_dim, neuron_dim, number_of_rotations, interpolation, euclidean_distance_dim, image_window_stride,
+        plans);
+
+    // Best coarse candidates of each neuron, ties are resolved by the lower transformation index
+    uint32_t number_of_coarse_transformations = coarse_transformations.size();
+    number_of_candidates = std::max(1U, std::min(number_of_candidates, number_of_coarse_transformations));
+    std::vector<uint32_t> candidates(som_size * number_of_candidates);
+
+    {
+        ScopedPhaseTimer timer(Phase::DISTANCE);
+
+        #pragma omp parallel
+        {
+            std::vector<std::pair<T, uint32_t>> coarse_distances(number_of_coarse_transformations);
+
+            #pragma omp for
+            for (int i = 0; i < static_cast<int>(som_size); ++i) {
+                for (uint32_t k = 0; k < number_of_coarse_transformations; ++k) {
+                    coarse_distances[k] = std::make_pair(distance(i, coarse_transformations[k]), coarse_transformations[k]);
+                }
+                std::partial_sort(coarse_distances.begin(), coarse_distances.begin() + number_of_candidates, coarse_distances.end());
+                for (uint32_t c = 0; c < number_of_candidates; ++c) {
+                    candidates[i * number_of_candidates + c] = coarse_distances[c].second;
+                }
+                euclidean_distance_matrix[i] = coarse_distances[0].first;
+                best_rotation_matrix[i] = coarse_distances[0].second;
+            }
+        }
+    }
+
+    if (step == 1) return;
+
+    // Neighboring angles of the candidates, which are not yet generated
+    auto&& neighbor = [&](uint32_t t, int d) {
+        uint32_t flip_offset = t / number_of_rotations * number_of_rotations;
+        return flip_offset + (t % number_of_rotations + number_of_rotations + d) % number_of_rotations;
+    };
+
+    std::vector<uint32_t> fine_transformations;
+    for (auto&& t : candidates) {
+        for (int d = 1; d < static_cast<int>(step); ++d) {
+            for (auto&& n : {neighbor(t, -d), neighbor(t, d)}) {
+                if (generated[n]) continue;
+                fine_transformations.push_back(n);
+                generated[n] = 1;
+            }
+        }
+    }
+    generate_spatial_transformations_on_demand(spatial_transformed_images, packed_images, fine_transformations,
+        image, image_dim, neuron_dim, number_of_rotations, interpolation, euclidean_distance_dim, image_window_stride,
+        plans);
+
+    // Refinement around the candidates
+    ScopedPhaseTimer timer(Phase::DISTANCE);
+    #pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(som_size); ++i) {
+        for (uint32_t c = 0; c < number_of_candidates; ++c) {
+            uint32_t t = candidates[i * number_of_candidates + c];
+            for (int d = 1 - static_cast<int>(step); d < static_cast<int>(step); ++d) {
+                uint32_t n = neighbor(t, d);
+                T tmp = distance(i, n);
+                if (tmp < euclidean_distance_matrix[i] or (tmp == euclidean_distance_matrix[i] and n < best_rotation_matrix[i])) {
+                    euclidean_distance_matrix[i] = tmp;
+                    best_rotation_matrix[i] = n;
+                }
+            }
+        }
+    }
+}
+
+/// Same as above with temporary storage of the packed windows
+template <typename T>
+void generate_euclidean_distance_matrix_coarse_to_fine(std::vector<T>& euclidean_distance_matrix,
+    std::vector<uint32_t>& best_rotation_matrix, uint32_t som_size, T const *packed_som,
+    T const *image, uint32_t image_dim, uint32_t neuron_dim, uint32_t number_of_rotations, bool use_flip,
+    Interpolation interpolation, uint32_t euclidean_distance_dim, uint32_t coarse_rotation_step,
+    uint32_t number_of_candidates, std::vector<T>& spatial_transformed_images, uint32_t som_window_stride = 0)
+{
+    AlignedVector<T> packed_images;
+    generate_euclidean_distance_matrix_coarse_to_fine(euclidean_distance_matrix, best_rotation_matrix, som_size,
+        packed_som, image, image_dim, neuron_dim, number_of_rotations, use_flip, interpolation, euclidean_distance_dim,
+        coarse_rotation_step, number_of_candidates, spatial_transformed_images, packed_images, som_window_stride);
+}
+
+} // namespace pink
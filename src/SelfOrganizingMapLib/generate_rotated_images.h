@@ -8,28 +8,101 @@
 
 #define _USE_MATH_DEFINES
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <map>
+#include <mutex>
 #include <omp.h>
 #include <vector>
 
 #include "Data.h"
+#include "DataView.h"
 #include "ImageProcessingLib/crop.h"
 #include "ImageProcessingLib/flip.h"
 #include "ImageProcessingLib/resize.h"
 #include "ImageProcessingLib/rotate.h"
 #include "ImageProcessingLib/rotate_and_crop.h"
 #include "ImageProcessingLib/rotate_90_degrees.h"
+#include "ImageProcessingLib/rotation_plan.h"
+#include "UtilitiesLib/PhaseTimer.h"
 #include "UtilitiesLib/pink_exception.h"
 
 namespace pink {
 
+typedef std::vector<BilinearRotationPlan> BilinearRotationPlans;
+
+/// Returns the bilinear rotation plans of the angles i * 2 pi / number_of_rotations for
+/// 0 < i < number_of_rotations / 4, which are used by @generate_rotated_images
+inline BilinearRotationPlans create_bilinear_rotation_plans(uint32_t image_dim, uint32_t neuron_dim,
+    uint32_t number_of_rotations)
+{
+    BilinearRotationPlans plans;
+    int num_real_rot = number_of_rotations / 4;
+    float angle_step_radians = 2.0 * M_PI / number_of_rotations;
+    for (int i = 1; i < num_real_rot; ++i) {
+        plans.emplace_back(image_dim, image_dim, neuron_dim, neuron_dim, i * angle_step_radians);
+    }
+    return plans;
+}
+
+/// Bilinear rotation plans of a trainer or mapper. The plans of an image dimension are created
+/// at its first request, shared by all threads, and released together with their owner.
+class BilinearRotationPlanCache
+{
+public:
+
+    BilinearRotationPlanCache(uint32_t neuron_dim, uint32_t number_of_rotations, Interpolation interpolation)
+     : neuron_dim(neuron_dim),
+       number_of_rotations(number_of_rotations),
+       use_plans(interpolation == Interpolation::BILINEAR and number_of_rotations / 4 > 1)
+    {}
+
+    /// Returns the plans for images with the given dimension,
+    /// nullptr if the spatial transformations do not need bilinear rotations
+    BilinearRotationPlans const* get(uint32_t image_dim) const
+    {
+        if (!use_plans) return nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto&& plans = cache[image_dim];
+        if (plans.empty()) plans = create_bilinear_rotation_plans(image_dim, neuron_dim, number_of_rotations);
+        return &plans;
+    }
+
+private:
+
+    uint32_t neuron_dim;
+    uint32_t number_of_rotations;
+    bool use_plans;
+
+    mutable std::mutex mutex;
+    mutable std::map<uint32_t, BilinearRotationPlans> cache;
+};
+
+/// Returns the number of elements of all spatial transformations generated by @generate_rotated_images
+template <typename LayoutType, typename T>
+size_t get_rotated_images_size(DataView<LayoutType, T> const& data, uint32_t number_of_rotations,
+    bool use_flip, uint32_t neuron_dim)
+{
+    size_t spacing = 1;
+    for (uint32_t i = 2; i < data.get_layout().dimensionality; ++i) spacing *= data.get_dimension()[i];
+    return number_of_rotations * (use_flip ? 2 : 1) * spacing * neuron_dim * neuron_dim;
+}
+
 /// If the input data is an image with two or more dimensions
 /// it will be rotated in the plain spanned by the first two dimensions.
+/// The spatial transformations are written into the caller-provided storage rotated_images,
+/// which must hold at least @get_rotated_images_size elements.
+/// The bilinear rotations use the given plans (see @BilinearRotationPlanCache) or are
+/// calculated directly if no plans are given.
 template <typename LayoutType, typename T>
-auto generate_rotated_images(Data<LayoutType, T> const& data,
-    uint32_t number_of_rotations, bool use_flip, Interpolation interpolation, uint32_t neuron_dim)
+void generate_rotated_images(T *rotated_images, DataView<LayoutType, T> const& data,
+    uint32_t number_of_rotations, bool use_flip, Interpolation interpolation, uint32_t neuron_dim,
+    BilinearRotationPlans const *plans = nullptr)
 {
+    ScopedPhaseTimer timer(Phase::ROTATION);
+
     // Images must have at least two dimensions
     if (data.get_layout().dimensionality < 2) throw pink::exception("Date must have at least two dimensions for image rotation.");
     // Images must be quadratic
@@ -39,15 +112,14 @@ auto generate_rotated_images(Data<LayoutType, T> const& data,
     auto image_size = data.get_dimension()[0] * data.get_dimension()[1];
     auto neuron_size = neuron_dim * neuron_dim;
 
-    uint32_t number_of_spatial_transformations = number_of_rotations * (use_flip ? 2 : 1);
-    std::vector<T> rotated_images(number_of_spatial_transformations * neuron_size);
-
     int num_real_rot = number_of_rotations / 4;
     T angle_step_radians = 2.0 * M_PI / number_of_rotations;
 
     int spacing = data.get_layout().dimensionality > 2 ? data.get_dimension()[2] : 1;
     for (uint32_t i = 3; i < data.get_layout().dimensionality; ++i) spacing *= data.get_dimension()[i];
 
+    if (interpolation != Interpolation::BILINEAR) plans = nullptr;
+
     int offset1 = num_real_rot * spacing * neuron_size;
     int offset2 = 2 * offset1;
     int offset3 = 3 * offset1;
@@ -73,7 +145,8 @@ auto generate_rotated_images(Data<LayoutType, T> const& data,
         for (int j = 0; j < spacing; ++j) {
             T const *current_image = &data[j * image_size];
             T *current_rotated_image = &rotated_images[(i * spacing + j) * neuron_size];
-            rotate(current_image, current_rotated_image, image_dim, image_dim, neuron_dim, neuron_dim, i * angle_step_radians, interpolation);
+            if (plans) (*plans)[i - 1](current_image, current_rotated_image);
+            else rotate(current_image, current_rotated_image, image_dim, image_dim, neuron_dim, neuron_dim, i * angle_step_radians, interpolation);
             //rotate_and_crop(current_image, current_rotated_image, image_dim, image_dim, neuron_dim, neuron_dim, i * angle_step_radians, interpolation);
             rotate_90_degrees(current_rotated_image, current_rotated_image + offset1, neuron_dim, neuron_dim);
             rotate_90_degrees(current_rotated_image + offset1, current_rotated_image + offset2, neuron_dim, neuron_dim);
@@ -93,8 +166,73 @@ auto generate_rotated_images(Data<LayoutType, T> const& data,
             }
         }
     }
+}
 
+/// Same as above, returning the spatial transformations in a new vector
+template <typename LayoutType, typename T>
+auto generate_rotated_images(DataView<LayoutType, T> const& data,
+    uint32_t number_of_rotations, bool use_flip, Interpolation interpolation, uint32_t neuron_dim,
+    BilinearRotationPlans const *plans = nullptr)
+{
+    std::vector<T> rotated_images(get_rotated_images_size(data, number_of_rotations, use_flip, neuron_dim));
+    generate_rotated_images(&rotated_images[0], data, number_of_rotations, use_flip, interpolation, neuron_dim, plans);
     return rotated_images;
 }
 
+template <typename LayoutType, typename T>
+auto generate_rotated_images(Data<LayoutType, T> const& data,
+    uint32_t number_of_rotations, bool use_flip, Interpolation interpolation, uint32_t neuron_dim,
+    BilinearRotationPlans const *plans = nullptr)
+{
+    return generate_rotated_images(DataView<LayoutType, T>(data), number_of_rotations, use_flip,
+        interpolation, neuron_dim, plans);
+}
+
+/// Generates a single spatial transformation of a two-dimensional quadratic image. The result is
+/// identical to the corresponding entry of @generate_rotated_images. The transformation index is
+/// given by flip * number_of_rotations + angle index in units of 360 / number_of_rotations degrees.
+/// The caller-provided buffer with neuron_dim * neuron_dim elements is used for the intermediate results.
+/// The optional bilinear rotation plans are used as in @generate_rotated_images.
+template <typename T>
+void generate_rotated_image(T *rotated_image, T const *image, uint32_t image_dim, uint32_t neuron_dim,
+    uint32_t number_of_rotations, uint32_t transformation, Interpolation interpolation, T *buffer,
+    BilinearRotationPlans const *plans = nullptr)
+{
+    uint32_t neuron_size = neuron_dim * neuron_dim;
+    uint32_t num_real_rot = std::max(1U, number_of_rotations / 4);
+    uint32_t angle_index = transformation % number_of_rotations;
+    uint32_t number_of_quarter_rotations = angle_index / num_real_rot;
+    int real_rotation = angle_index % num_real_rot;
+    bool flipped = transformation >= number_of_rotations;
+    T angle_step_radians = 2.0 * M_PI / number_of_rotations;
+
+    // The steps alternate between the result and the buffer, so that the last one writes the result
+    bool odd_number_of_steps = (1 + number_of_quarter_rotations + flipped) % 2;
+    T *current = odd_number_of_steps ? rotated_image : buffer;
+    T *next = odd_number_of_steps ? buffer : rotated_image;
+
+    std::fill(current, current + neuron_size, T(0));
+    if (real_rotation == 0) resize(image, current, image_dim, image_dim, neuron_dim, neuron_dim);
+    else if (plans and interpolation == Interpolation::BILINEAR) (*plans)[real_rotation - 1](image, current);
+    else rotate(image, current, image_dim, image_dim, neuron_dim, neuron_dim, real_rotation * angle_step_radians, interpolation);
+
+    for (uint32_t i = 0; i < number_of_quarter_rotations; ++i) {
+        rotate_90_degrees(current, next, neuron_dim, neuron_dim);
+        std::swap(current, next);
+    }
+
+    if (flipped) flip(current, next, neuron_dim, neuron_dim);
+}
+
+/// Same as above with a temporary buffer
+template <typename T>
+void generate_rotated_image(T *rotated_image, T const *image, uint32_t image_dim, uint32_t neuron_dim,
+    uint32_t number_of_rotations, uint32_t transformation, Interpolation interpolation,
+    BilinearRotationPlans const *plans = nullptr)
+{
+    std::vector<T> buffer(neuron_dim * neuron_dim);
+    generate_rotated_image(rotated_image, image, image_dim, neuron_dim, number_of_rotations, transformation,
+        interpolation, &buffer[0], plans);
+}
+
 } // namespace pink
@@ -0,0 +1,146 @@
+/**
+ * @file   UtilitiesLib/AlignedAllocator.h
+ * @brief  Allocator for cache line and page aligned storage with optional huge pages.
+ *
+ * Allocations are aligned to the cache line size, allocations of at least one page are
+ * page aligned. If huge pages are switched on (see @set_use_huge_pages), allocations of at
+ * least one huge page are aligned to the huge page size and transparent huge pages are requested.
+ *
+ * The elements are default-initialized, i.e. the memory of trivial types is not touched
+ * by the allocating thread. On multi-socket machines the memory pages are placed on the
+ * NUMA node of the thread writing them first. Therefore, the storage should be initialized
+ * by @first_touch using the same static OpenMP partition as the loops working on it.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace pink {
+
+static const size_t cache_line_size = 64;
+
+static const size_t huge_page_size = 2 * 1024 * 1024;
+
+inline std::atomic<bool>& get_use_huge_pages_flag()
+{
+    static std::atomic<bool> use_huge_pages(false);
+    return use_huge_pages;
+}
+
+/// Switches the usage of transparent huge pages for large allocations on or off
+inline void set_use_huge_pages(bool value)
+{
+    get_use_huge_pages_flag().store(value, std::memory_order_relaxed);
+}
+
+inline bool get_use_huge_pages()
+{
+    return get_use_huge_pages_flag().load(std::memory_order_relaxed);
+}
+
+/// Returns the alignment of an allocation with the given number of bytes
+inline size_t get_alignment(size_t bytes)
+{
+    static const size_t page_size = sysconf(_SC_PAGESIZE);
+
+    if (get_use_huge_pages() and bytes >= huge_page_size) return huge_page_size;
+    if (bytes >= page_size) return page_size;
+    return cache_line_size;
+}
+
+/// Standard allocator for aligned storage, see file description
+template <typename T>
+class AlignedAllocator
+{
+public:
+
+    typedef T value_type;
+
+    AlignedAllocator() noexcept {}
+
+    template <typename U>
+    AlignedAllocator(AlignedAllocator<U> const&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        size_t bytes = std::max(n * sizeof(T), static_cast<size_t>(1));
+        size_t alignment = get_alignment(bytes);
+
+        void *p = nullptr;
+        if (posix_memalign(&p, alignment, bytes) != 0) throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+        if (alignment == huge_page_size) madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T *p, size_t) noexcept
+    {
+        std::free(p);
+    }
+
+    /// Default-initialization instead of value-initialization, the memory is not touched
+    template <typename U>
+    void construct(U *p) noexcept(std::is_nothrow_default_constructible<U>::value)
+    {
+        ::new(static_cast<void*>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U *p, Args&&... args)
+    {
+        ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template <typename T, typename U>
+bool operator == (AlignedAllocator<T> const&, AlignedAllocator<U> const&) { return true; }
+
+template <typename T, typename U>
+bool operator != (AlignedAllocator<T> const&, AlignedAllocator<U> const&) { return false; }
+
+/// Vector with aligned and uninitialized storage
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/// Returns the number of elements rounded up to full cache lines, used as stride of
+/// arrays in a contiguous storage, so that every array starts at a cache line
+template <typename T>
+size_t get_padded_size(size_t size)
+{
+    static_assert(cache_line_size % sizeof(T) == 0, "Size of T must be a divisor of the cache line size");
+    size_t elements_per_cache_line = cache_line_size / sizeof(T);
+    return (size + elements_per_cache_line - 1) / elements_per_cache_line * elements_per_cache_line;
+}
+
+/// Initializes all elements with value using the static OpenMP partition of the elements
+template <typename T>
+void first_touch(T *data, size_t size, T value = T())
+{
+    #pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < static_cast<int64_t>(size); ++i) data[i] = value;
+}
+
+/// Initializes all elements by a copy of values using the static OpenMP partition of the elements
+template <typename T>
+void first_touch(T *data, T const *values, size_t size)
+{
+    #pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < static_cast<int64_t>(size); ++i) data[i] = values[i];
+}
+
+} // namespace pink
@@ -0,0 +1,200 @@
+/**
+ * @file   UtilitiesLib/BufferedWriter.h
+ * @brief  Buffered output file with optional background flush and direct I/O.
+ *
+ * Small writes are collected in a large page-aligned buffer, which is written by a single
+ * system call. With the background flush, a full buffer is written asynchronously while
+ * the next one is filled. With direct I/O (O_DIRECT) the page cache is bypassed, which avoids
+ * the eviction of the data file by large result files. If the file system does not support
+ * direct I/O, it is silently switched off.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <future>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <utility>
+
+#include "pink_exception.h"
+
+namespace pink {
+
+class BufferedWriter
+{
+public:
+
+    /// Alignment of the buffers and their size required for direct I/O
+    static const size_t alignment = 4096;
+
+    /// The buffer size is rounded up to a multiple of the alignment
+    explicit BufferedWriter(std::string const& filename, size_t buffer_size = 4 << 20,
+        bool background_flush = false, bool direct_io = false)
+     : filename(filename),
+       fd(-1),
+       direct_io(direct_io),
+       buffer_size(std::max((buffer_size + alignment - 1) / alignment * alignment, alignment)),
+       current(allocate(this->buffer_size)),
+       current_size(0),
+       background_flush(background_flush)
+    {
+        int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+        if (direct_io) {
+            fd = ::open(filename.c_str(), flags | O_DIRECT, 0644);
+            if (fd == -1 and errno != EINVAL) throw_error("open");
+        }
+#endif
+        if (fd == -1) {
+            this->direct_io = false;
+            fd = ::open(filename.c_str(), flags, 0644);
+            if (fd == -1) throw_error("open");
+        }
+
+        if (background_flush) pending = allocate(this->buffer_size);
+    }
+
+    ~BufferedWriter()
+    {
+        try {
+            close();
+        } catch (...) {}
+    }
+
+    BufferedWriter(BufferedWriter const&) = delete;
+    BufferedWriter& operator = (BufferedWriter const&) = delete;
+
+    /// Append size bytes
+    void write(void const *data, size_t size)
+    {
+        auto&& p = static_cast<char const*>(data);
+        while (size != 0) {
+            size_t n = std::min(size, buffer_size - current_size);
+            std::memcpy(current.get() + current_size, p, n);
+            current_size += n;
+            p += n;
+            size -= n;
+            if (current_size == buffer_size) flush();
+        }
+    }
+
+    /// Append the bytes of a trivially copyable value
+    template <typename V>
+    void write(V const& value)
+    {
+        write(&value, sizeof(V));
+    }
+
+    /// Writes all buffered data and closes the file. Errors of the background flush are rethrown.
+    void close()
+    {
+        if (fd == -1) return;
+
+        try {
+            if (pending_write.valid()) pending_write.get();
+
+            if (current_size != 0) {
+                // The remainder is not a multiple of the alignment
+#ifdef O_DIRECT
+                if (direct_io) ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_DIRECT);
+#endif
+                write_all(current.get(), current_size);
+                current_size = 0;
+            }
+        } catch (...) {
+            ::close(fd);
+            fd = -1;
+            throw;
+        }
+
+        int result = ::close(fd);
+        fd = -1;
+        if (result == -1) throw_error("close");
+    }
+
+    /// Returns true if the file is written with direct I/O
+    bool is_direct_io() const { return direct_io; }
+
+private:
+
+    struct Free
+    {
+        void operator () (char *p) const { std::free(p); }
+    };
+
+    typedef std::unique_ptr<char, Free> Buffer;
+
+    static Buffer allocate(size_t size)
+    {
+        void *p = nullptr;
+        if (::posix_memalign(&p, alignment, size) != 0) throw pink::exception("BufferedWriter: allocation failed");
+        return Buffer(static_cast<char*>(p));
+    }
+
+    void throw_error(std::string const& operation) const
+    {
+        throw pink::exception("BufferedWriter: " + operation + " of " + filename + " failed: " + std::strerror(errno));
+    }
+
+    void write_all(char const *data, size_t size)
+    {
+        while (size != 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n == -1) {
+                if (errno == EINTR) continue;
+                throw_error("write");
+            }
+            data += n;
+            size -= n;
+        }
+    }
+
+    /// Writes the full current buffer
+    void flush()
+    {
+        if (!background_flush) {
+            write_all(current.get(), current_size);
+            current_size = 0;
+            return;
+        }
+
+        // Wait until the previous buffer is written and hand over the current one
+        if (pending_write.valid()) pending_write.get();
+        std::swap(current, pending);
+        size_t size = current_size;
+        pending_write = std::async(std::launch::async, [this, size](){ write_all(pending.get(), size); });
+        current_size = 0;
+    }
+
+    std::string filename;
+
+    int fd;
+
+    bool direct_io;
+
+    size_t buffer_size;
+
+    /// Buffer filled by write
+    Buffer current;
+
+    size_t current_size;
+
+    bool background_flush;
+
+    /// Buffer written in the background
+    Buffer pending;
+
+    /// Background write of the pending buffer
+    std::future<void> pending_write;
+};
+
+} // namespace pink
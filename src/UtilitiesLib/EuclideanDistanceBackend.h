@@ -0,0 +1,28 @@
+/**
+ * @file   UtilitiesLib/EuclideanDistanceBackend.h
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <ostream>
+
+namespace pink {
+
+//! Algorithm for the CPU calculation of the euclidean distance matrix
+enum class EuclideanDistanceBackend {
+    DIRECT,  //!< Sum of squared differences for each pair of neuron and transformed image
+    GEMM     //!< ||a||^2 + ||b||^2 - 2 a*b using a cache-blocked matrix multiplication
+};
+
+//! Pretty printing of EuclideanDistanceBackend
+inline std::ostream& operator << (std::ostream& os, EuclideanDistanceBackend backend)
+{
+    if (backend == EuclideanDistanceBackend::DIRECT) os << "direct";
+    else if (backend == EuclideanDistanceBackend::GEMM) os << "gemm";
+    else os << "undefined";
+    return os;
+}
+
+} // namespace pink
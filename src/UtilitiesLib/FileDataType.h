@@ -0,0 +1,142 @@
+/**
+ * @file   UtilitiesLib/FileDataType.h
+ * @brief  Data types of the entries stored in data files.
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include "pink_exception.h"
+
+namespace pink {
+
+/// Supported data types of data files, the values are the codes of FILE_FORMATS.md.
+/// The values of the integer types are converted without scaling.
+enum class FileDataType : int
+{
+    FLOAT32 = 0,
+    UINT8 = 6,
+    UINT16 = 7,
+    FLOAT16 = 10
+};
+
+inline std::ostream& operator << (std::ostream& os, FileDataType type)
+{
+    if (type == FileDataType::FLOAT32) os << "float32";
+    else if (type == FileDataType::UINT8) os << "uint8";
+    else if (type == FileDataType::UINT16) os << "uint16";
+    else if (type == FileDataType::FLOAT16) os << "float16";
+    else os << "undefined";
+    return os;
+}
+
+/// Returns the data type of the code in the binary header of a data file
+inline FileDataType get_file_data_type(int code)
+{
+    switch (code) {
+        case 0: return FileDataType::FLOAT32;
+        case 6: return FileDataType::UINT8;
+        case 7: return FileDataType::UINT16;
+        case 10: return FileDataType::FLOAT16;
+        default: throw pink::exception("Data type " + std::to_string(code) + " of data file is not supported"
+            " (0: float32, 6: uint8, 7: uint16, 10: float16).");
+    }
+}
+
+/// Size of one value in bytes
+inline size_t get_size(FileDataType type)
+{
+    switch (type) {
+        case FileDataType::UINT8: return 1;
+        case FileDataType::UINT16:
+        case FileDataType::FLOAT16: return 2;
+        default: return 4;
+    }
+}
+
+/// Returns true if the values of the file can be used as T without conversion
+template <typename T>
+bool is_native(FileDataType type)
+{
+    return type == FileDataType::FLOAT32 and std::is_same<T, float>::value;
+}
+
+/// Converts an IEEE 754 half precision value
+inline float float16_to_float(uint16_t h)
+{
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    uint32_t bits;
+
+    if (exponent == 0x1f) {
+        // Infinity and NaN
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // Subnormal half values are normal single values
+        exponent = 113;
+        while (!(mantissa & 0x400)) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+
+    float f;
+    std::memcpy(&f, &bits, sizeof(float));
+    return f;
+}
+
+/// Converts size values of the file data type stored at src
+template <typename T>
+void convert(char const *src, FileDataType type, T *dst, size_t size)
+{
+    switch (type) {
+        case FileDataType::UINT8:
+        {
+            auto&& p = reinterpret_cast<uint8_t const*>(src);
+            for (size_t i = 0; i < size; ++i) dst[i] = static_cast<T>(p[i]);
+            break;
+        }
+        case FileDataType::UINT16:
+        {
+            for (size_t i = 0; i < size; ++i) {
+                uint16_t v;
+                std::memcpy(&v, src + i * sizeof(uint16_t), sizeof(uint16_t));
+                dst[i] = static_cast<T>(v);
+            }
+            break;
+        }
+        case FileDataType::FLOAT16:
+        {
+            for (size_t i = 0; i < size; ++i) {
+                uint16_t v;
+                std::memcpy(&v, src + i * sizeof(uint16_t), sizeof(uint16_t));
+                dst[i] = static_cast<T>(float16_to_float(v));
+            }
+            break;
+        }
+        default:
+        {
+            for (size_t i = 0; i < size; ++i) {
+                float v;
+                std::memcpy(&v, src + i * sizeof(float), sizeof(float));
+                dst[i] = static_cast<T>(v);
+            }
+            break;
+        }
+    }
+}
+
+} // namespace pink
@@ -4,6 +4,7 @@
  * @author Bernd Doser, HITS gGmbH
  */
 
+#include <algorithm>
 #include <cmath>
 #include <getopt.h>
 #include <fstream>
@@ -32,10 +33,14 @@ InputData::InputData()
    number_of_threads(-1),
    init(SOMInitialization::ZERO),
    numIter(1),
+   batch_size(1),
+   hogwild(false),
    number_of_progress_prints(10),
    use_flip(true),
    use_gpu(true),
    number_of_data_entries(0),
+   data_type(FileDataType::FLOAT32),
+   chunked_data(false),
    data_layout(Layout::CARTESIAN),
    som_size(0),
    neuron_size(0),
@@ -52,7 +57,19 @@ InputData::InputData()
    usePBC(false),
    dimensionality(1),
    write_rot_flip(false),
-   euclidean_distance_type(DataType::UINT8)
+   euclidean_distance_type(DataType::UINT8),
+   euclidean_distance_backend(EuclideanDistanceBackend::DIRECT),
+   coarse_rotation_step(1),
+   number_of_refinement_candidates(2),
+   use_mmap(true),
+   prefetch_size(0),
+   shuffle_block_size(0),
+   shuffle_buffer_size(0),
+   write_buffer_size(4 << 20),
+   write_async(false),
+   direct_io(false),
+   use_huge_pages(false),
+   top_k(0)
 {}
 
 InputData::InputData(int argc, char **argv)
@@ -86,6 +103,23 @@ InputData::InputData(int argc, char **argv)
         {"pbc",                          0, 0, 14},
         {"store-rot-flip",               1, 0, 15},
         {"euclidean-distance-type",      1, 0, 16},
+        {"euclidean-distance-backend",   1, 0, 17},
+        {"batch-size",                   1, 0, 18},
+        {"hogwild",                      0, 0, 19},
+        {"coarse-rotation-step",         1, 0, 20},
+        {"refinement-candidates",        1, 0, 21},
+        {"mmap-off",                     0, 0, 22},
+        {"prefetch",                     1, 0, 23},
+        {"shuffle-block-size",           1, 0, 24},
+        {"shuffle-buffer-size",          1, 0, 25},
+        {"write-buffer-size",            1, 0, 26},
+        {"write-async",                  0, 0, 27},
+        {"direct-io",                    0, 0, 28},
+        {"top-k",                        1, 0, 29},
+        {"checkpoint",                   1, 0, 30},
+        {"resume",                       1, 0, 31},
+        {"metrics-file",                 1, 0, 32},
+        {"huge-pages",                   0, 0, 33},
         {NULL, 0, NULL, 0}
     };
 
@@ -286,6 +320,147 @@ InputData::InputData(int argc, char **argv)
                 }
                 break;
             }
+            case 17:
+            {
+                stringToUpper(optarg);
+                if (strcmp(optarg, "DIRECT") == 0) euclidean_distance_backend = EuclideanDistanceBackend::DIRECT;
+                else if (strcmp(optarg, "GEMM") == 0) euclidean_distance_backend = EuclideanDistanceBackend::GEMM;
+                else {
+                    printf ("optarg = %s\n", optarg);
+                    printf ("Unkown option %o\n", c);
+                    print_usage();
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+            case 18:
+            {
+                int tmp = atoi(optarg);
+                if (tmp < 1) {
+                    print_usage();
+                    printf ("ERROR: Batch size must be larger than 0.\n");
+                    exit(EXIT_FAILURE);
+                }
+                batch_size = tmp;
+                break;
+            }
+            case 19:
+            {
+                hogwild = true;
+                break;
+            }
+            case 20:
+            {
+                int tmp = atoi(optarg);
+                if (tmp < 1) {
+                    print_usage();
+                    printf ("ERROR: Coarse rotation step must be larger than 0.\n");
+                    exit(EXIT_FAILURE);
+                }
+                coarse_rotation_step = tmp;
+                break;
+            }
+            case 21:
+            {
+                int tmp = atoi(optarg);
+                if (tmp < 1) {
+                    print_usage();
+                    printf ("ERROR: Number of refinement candidates must be larger than 0.\n");
+                    exit(EXIT_FAILURE);
+                }
+                number_of_refinement_candidates = tmp;
+                break;
+            }
+            case 22:
+            {
+                use_mmap = false;
+                break;
+            }
+            case 23:
+            {
+                int tmp = atoi(optarg);
+                if (tmp < 0) {
+                    print_usage();
+                    printf ("ERROR: Prefetch size must not be negative.\n");
+                    exit(EXIT_FAILURE);
+                }
+                prefetch_size = tmp;
+                break;
+            }
+            case 24:
+            {
+                int tmp = atoi(optarg);
+                if (tmp < 0) {
+                    print_usage();
+                    printf ("ERROR: Shuffle block size must not be negative.\n");
+                    exit(EXIT_FAILURE);
+                }
+                shuffle_block_size = tmp;
+                break;
+            }
+            case 25:
+            {
+                int tmp = atoi(optarg);
+                if (tmp < 1) {
+                    print_usage();
+                    printf ("ERROR: Shuffle buffer size must be larger than 0.\n");
+                    exit(EXIT_FAILURE);
+                }
+                shuffle_buffer_size = tmp;
+                break;
+            }
+            case 26:
+            {
+                int tmp = atoi(optarg);
+                if (tmp < 1) {
+                    print_usage();
+                    printf ("ERROR: Write buffer size must be larger than 0.\n");
+                    exit(EXIT_FAILURE);
+                }
+                write_buffer_size = static_cast<size_t>(tmp) << 20;
+                break;
+            }
+            case 27:
+            {
+                write_async = true;
+                break;
+            }
+            case 28:
+            {
+                direct_io = true;
+                break;
+            }
+            case 29:
+            {
+                int tmp = atoi(optarg);
+                if (tmp < 0) {
+                    print_usage();
+                    printf ("ERROR: Number of best matches must not be negative.\n");
+                    exit(EXIT_FAILURE);
+                }
+                top_k = tmp;
+                break;
+            }
+            case 30:
+            {
+                checkpoint_filename = optarg;
+                break;
+            }
+            case 31:
+            {
+                resume_filename = optarg;
+                break;
+            }
+            case 32:
+            {
+                metrics_filename = optarg;
+                break;
+            }
+            case 33:
+            {
+                use_huge_pages = true;
+                break;
+            }
             case 'v':
             {
                 std::cout << "Pink version " << PROJECT_VERSION << std::endl;
@@ -342,6 +517,19 @@ InputData::InputData(int argc, char **argv)
         throw pink::exception("Unkown execution path.");
     }
 
+    if (batch_size > 1 and use_gpu) throw pink::exception("Batch training and mapping are only supported by the CPU version (use --cuda-off).");
+    if (hogwild and use_gpu) throw pink::exception("Hogwild training is only supported by the CPU version (use --cuda-off).");
+    if (coarse_rotation_step > 1 and use_gpu) throw pink::exception("Coarse-to-fine rotation search is only supported by the CPU version (use --cuda-off).");
+    if (hogwild and batch_size > 1) throw pink::exception("Hogwild training can not be combined with batch training.");
+    if (prefetch_size > 0 and (hogwild or batch_size > 1)) throw pink::exception("Prefetching can not be combined with Hogwild, batch training or batch mapping.");
+    if (hogwild and !(checkpoint_filename.empty() and resume_filename.empty()))
+        throw pink::exception("Checkpoints can not be combined with Hogwild training.");
+    if (hogwild and intermediate_storage != IntermediateStorageType::OFF)
+        throw pink::exception("Intermediate SOM storage can not be combined with Hogwild training.");
+    if (hogwild and euclidean_distance_backend == EuclideanDistanceBackend::GEMM)
+        throw pink::exception("Hogwild training can not be combined with the GEMM backend of the euclidean distance.");
+    if (!resume_filename.empty() and executionPath != ExecutionPath::TRAIN) throw pink::exception("Only training can be resumed.");
+
     if (layout == Layout::HEXAGONAL) {
         if (usePBC) throw pink::exception("Periodic boundary conditions are not supported for hexagonal layout.");
         if ((som_width - 1) % 2) throw pink::exception("For hexagonal layout only odd dimension supported.");
@@ -352,6 +540,7 @@ InputData::InputData(int argc, char **argv)
     else som_size = som_width * som_height * som_depth;
 
     if (som_width < 2) throw pink::exception("som-width must be > 1.");
+    if (top_k > static_cast<uint32_t>(som_size)) throw pink::exception("top-k must not be larger than the number of neurons.");
     if (som_height < 1) throw pink::exception("som-height must be > 0.");
     if (som_depth < 1) throw pink::exception("som-depth must be > 0.");
     if (som_height > 1) ++dimensionality;
@@ -368,9 +557,14 @@ InputData::InputData(int argc, char **argv)
         last_position = ifs.tellg();
     }
 
-    int data_dimensionality;
-    // Ignore first three entries
-    ifs.seekg(last_position + 3 * sizeof(int), ifs.beg);
+    int file_type, data_type_code, data_dimensionality;
+    // Ignore version
+    ifs.seekg(last_position + sizeof(int), ifs.beg);
+    ifs.read((char*)&file_type, sizeof(int));
+    if (file_type != 0 and file_type != 4) throw pink::exception(data_filename + " is not a data file.");
+    chunked_data = file_type == 4;
+    ifs.read((char*)&data_type_code, sizeof(int));
+    data_type = get_file_data_type(data_type_code);
     ifs.read((char*)&number_of_data_entries, sizeof(int));
     ifs.read((char*)&data_layout, sizeof(int));
     ifs.read((char*)&data_dimensionality, sizeof(int));
@@ -390,6 +584,13 @@ InputData::InputData(int argc, char **argv)
         if (number_of_rotations != 1) euclidean_distance_dim *= std::sqrt(2.0) / 2.0;
     }
 
+    if (shuffle_buffer_size == 0) {
+        size_t entry_size = sizeof(float);
+        for (auto&& d : data_dimension) entry_size *= d;
+        shuffle_buffer_size = std::max(static_cast<size_t>(1),
+            (static_cast<size_t>(DEFAULT_SHUFFLE_BUFFER_MIB) << 20) / entry_size);
+    }
+
     neuron_size = neuron_dim * neuron_dim;
     som_total_size = som_size * neuron_size;
     number_of_spatial_transformations = use_flip ? 2 * number_of_rotations : number_of_rotations;
@@ -437,6 +638,7 @@ void InputData::print_parameters() const
         std::cout << "  SOM file = " << som_filename << "\n";
 
     std::cout << "  Number of data entries = " << number_of_data_entries << "\n"
+              << "  Data type = " << data_type << (chunked_data ? " (chunked)" : "") << "\n"
               << "  Data dimension = " << data_dimension[0];
 
     for (size_t i = 1; i < data_dimension.size(); ++i) std::cout << " x " << data_dimension[i];
@@ -445,6 +647,8 @@ void InputData::print_parameters() const
     std::cout << "  SOM dimension (width x height x depth) = " << som_width << "x" << som_height << "x" << som_depth << "\n"
               << "  SOM size = " << som_size << "\n"
               << "  Number of iterations = " << numIter << "\n"
+              << "  Batch size = " << batch_size << "\n"
+              << "  Hogwild training = " << hogwild << "\n"
               << "  Neuron dimension = " << neuron_dim << "x" << neuron_dim << "\n"
               << "  Euclidean distance dimension = " << euclidean_distance_dim << "x" << euclidean_distance_dim << "\n"
               << "  Number of progress information prints = " << number_of_progress_prints << "\n"
@@ -457,6 +661,18 @@ void InputData::print_parameters() const
               << "  Use mirrored image = " << use_flip << "\n"
               << "  Number of CPU threads = " << number_of_threads << "\n"
               << "  Use CUDA = " << use_gpu << "\n"
+              << "  Euclidean distance backend (CPU) = " << euclidean_distance_backend << "\n"
+              << "  Coarse rotation step (CPU) = " << coarse_rotation_step << "\n"
+              << "  Number of refinement candidates (CPU) = " << number_of_refinement_candidates << "\n"
+              << "  Use memory mapping of data file = " << use_mmap << "\n"
+              << "  Prefetch size = " << prefetch_size << "\n"
+              << "  Shuffle block size = " << shuffle_block_size << "\n"
+              << "  Shuffle buffer size = " << shuffle_buffer_size << "\n"
+              << "  Write buffer size (MiB) = " << (write_buffer_size >> 20) << "\n"
+              << "  Write asynchronously = " << write_async << "\n"
+              << "  Use direct I/O for writing = " << direct_io << "\n"
+              << "  Use huge pages = " << use_huge_pages << "\n"
+              << "  Number of best matches in mapping file = " << top_k << "\n"
               << "  Distribution function for SOM update = " << distribution_function << "\n"
               << "  Sigma = " << sigma << "\n"
               << "  Damping factor = " << damping << "\n"
@@ -467,6 +683,15 @@ void InputData::print_parameters() const
     if (!rot_flip_filename.empty())
         std::cout << "  Best rotation and flipping parameter filename = " << rot_flip_filename << "\n";
 
+    if (!checkpoint_filename.empty())
+        std::cout << "  Checkpoint file = " << checkpoint_filename << "\n";
+
+    if (!resume_filename.empty())
+        std::cout << "  Resume from checkpoint file = " << resume_filename << "\n";
+
+    if (!metrics_filename.empty())
+        std::cout << "  Performance metrics file = " << metrics_filename << "\n";
+
     if (verbose)
         std::cout << "  Block size 1 = " << block_size_1 << "\n";
 
@@ -484,28 +709,47 @@ void InputData::print_usage() const
                  "\n"
                  "  Options:\n"
                  "\n"
+                 "    --batch-size <int>              Number of images per batch SOM update or mapped in parallel (default = 1, online training).\n"
+                 "    --checkpoint <string>           Write the training state at every progress step for resuming with --resume.\n"
+                 "    --coarse-rotation-step <int>    Coarse-to-fine search of the best rotation, only every n-th angle is evaluated first (default = 1, exhaustive).\n"
                  "    --cuda-off                      Switch off CUDA acceleration.\n"
+                 "    --direct-io                     Write the mapping results bypassing the page cache (O_DIRECT).\n"
                  "    --dist-func, -f <string>        Distribution function for SOM update (see below).\n"
+                 "    --euclidean-distance-backend <string>\n"
+                 "                                    CPU algorithm for euclidean distances (direct = default, gemm).\n"
                  "    --flip-off                      Switch off usage of mirrored images.\n"
                  "    --help, -h                      Print this lines.\n"
+                 "    --hogwild                       Lock-free parallel online training of the CPU threads (not with --inter-store or the gemm backend).\n"
+                 "    --huge-pages                    Align large allocations to huge pages and request transparent huge pages.\n"
                  "    --init, -x <string>             Type of SOM initialization (zero = default, random, random_with_preferred_direction, file_init).\n"
-                 "    --interpolation <string>        Type of image interpolation for rotations (nearest_neighbor, bilinear = default).\n"
                  "    --inter-store <string>          Store intermediate SOM results at every progress step (off = default, overwrite, keep).\n"
+                 "    --interpolation <string>        Type of image interpolation for rotations (nearest_neighbor, bilinear = default).\n"
                  "    --layout, -l <string>           Layout of SOM (quadratic = default, hexagonal).\n"
+                 "    --max-update-distance <float>   Maximum distance for SOM update (default = off).\n"
+                 "    --metrics-file <string>         Write the times of the processing phases of each thread as JSON lines at every progress step.\n"
+                 "    --mmap-off                      Switch off memory mapping of the data file.\n"
                  "    --neuron-dimension, -d <int>    Dimension for quadratic SOM neurons (default = image-dimension * sqrt(2)/2).\n"
+                 "    --num-iter <int>                Number of iterations (default = 1).\n"
                  "    --numrot, -n <int>              Number of rotations (1 or a multiple of 4, default = 360).\n"
                  "    --numthreads, -t <int>          Number of CPU threads (default = auto).\n"
-                 "    --num-iter <int>                Number of iterations (default = 1).\n"
                  "    --pbc                           Use periodic boundary conditions for SOM.\n"
+                 "    --prefetch <int>                Number of data entries read and rotated asynchronously in advance (default = 0, off).\n"
                  "    --progress, -p <int>            Number of progress information prints (default = 10).\n"
+                 "    --refinement-candidates <int>   Number of best coarse angles per neuron which are refined (default = 2).\n"
+                 "    --resume <string>               Resume the training from a checkpoint file of the same data and parameters.\n"
                  "    --seed, -s <int>                Seed for random number generator (default = 1234).\n"
-                 "    --store-rot-flip <string>       Store the rotation and flip information of the best match of mapping.\n"
-                 "    --som-width <int>               Width dimension of SOM (default = 10).\n"
-                 "    --som-height <int>              Height dimension of SOM (default = 10).\n"
+                 "    --shuffle-block-size <int>      Number of contiguous data entries, whose order is shuffled as a block (default = 0, full shuffle).\n"
+                 "    --shuffle-buffer-size <int>     Number of data entries of consecutive blocks, which are shuffled in memory.\n"
+                 "                                    The buffer needs this number times the data size as memory (default = 256 MiB of entries).\n"
                  "    --som-depth <int>               Depth dimension of SOM (default = 1).\n"
-                 "    --max-update-distance <float>   Maximum distance for SOM update (default = off).\n"
-                 "    --version, -v                   Print version number.\n"
+                 "    --som-height <int>              Height dimension of SOM (default = 10).\n"
+                 "    --som-width <int>               Width dimension of SOM (default = 10).\n"
+                 "    --store-rot-flip <string>       Store the rotation and flip information of the best match of mapping.\n"
+                 "    --top-k <int>                   Store only the k best matching neurons of each image in the mapping file (default = 0, all distances).\n"
                  "    --verbose                       Print more output.\n"
+                 "    --version, -v                   Print version number.\n"
+                 "    --write-async                   Write the mapping results by a background thread.\n"
+                 "    --write-buffer-size <int>       Size of the buffers for writing the mapping results in MiB (default = 4).\n"
                  "\n"
                  "  Distribution function:\n"
                  "\n"
@@ -16,7 +16,9 @@
 #include "UtilitiesLib/DataType.h"
 #include "UtilitiesLib/DistributionFunction.h"
 #include "UtilitiesLib/DistributionFunctor.h"
+#include "UtilitiesLib/EuclideanDistanceBackend.h"
 #include "UtilitiesLib/ExecutionPath.h"
+#include "UtilitiesLib/FileDataType.h"
 #include "UtilitiesLib/Layout.h"
 #include "UtilitiesLib/Interpolation.h"
 #include "Version.h"
@@ -26,6 +28,9 @@ namespace pink {
 #define DEFAULT_SIGMA     1.1
 #define DEFAULT_DAMPING   0.2
 
+/// Memory of the shuffle buffer in MiB, if the number of entries is not given
+#define DEFAULT_SHUFFLE_BUFFER_MIB 256
+
 struct InputData
 {
     /// Default constructor
@@ -50,6 +55,9 @@ struct InputData
     std::string result_filename;
     std::string som_filename;
     std::string rot_flip_filename;
+    std::string checkpoint_filename;
+    std::string resume_filename;
+    std::string metrics_filename;
 
     bool verbose;
     uint32_t som_width;
@@ -63,10 +71,14 @@ struct InputData
     int number_of_threads;
     SOMInitialization init;
     int numIter;
+    uint32_t batch_size;
+    bool hogwild;
     int number_of_progress_prints;
     bool use_flip;
     bool use_gpu;
     uint32_t number_of_data_entries;
+    FileDataType data_type;
+    bool chunked_data;
     Layout data_layout;
     std::vector<uint32_t> data_dimension;
     int som_size;
@@ -85,6 +97,18 @@ struct InputData
     int dimensionality;
     bool write_rot_flip;
     DataType euclidean_distance_type;
+    EuclideanDistanceBackend euclidean_distance_backend;
+    uint32_t coarse_rotation_step;
+    uint32_t number_of_refinement_candidates;
+    bool use_mmap;
+    uint32_t prefetch_size;
+    uint32_t shuffle_block_size;
+    uint32_t shuffle_buffer_size;
+    size_t write_buffer_size;
+    bool write_async;
+    bool direct_io;
+    bool use_huge_pages;
+    uint32_t top_k;
 };
 
 void stringToUpper(char* s);
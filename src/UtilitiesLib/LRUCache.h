@@ -0,0 +1,76 @@
+/**
+ * @file   UtilitiesLib/LRUCache.h
+ * @brief  Small cache replacing the least recently used value.
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pink {
+
+/// Cache for a few expensive values, e.g. decompressed chunks. The values are searched
+/// linearly, which is faster than a hash map for small capacities and keeps the cache copyable.
+template <typename Key, typename Value>
+class LRUCache
+{
+public:
+
+    explicit LRUCache(size_t capacity)
+     : capacity(std::max(capacity, size_t(1))),
+       time(0)
+    {}
+
+    /// Returns the cached value or nullptr
+    Value* find(Key const& key)
+    {
+        for (auto&& entry : entries) {
+            if (entry.key == key) {
+                entry.last_use = ++time;
+                return &entry.value;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Inserts a value, which is not cached, and returns the cached value.
+    /// The least recently used value is replaced if the cache is full.
+    Value& insert(Key const& key, Value value)
+    {
+        if (entries.size() < capacity) {
+            entries.push_back(Entry{key, std::move(value), ++time});
+            return entries.back().value;
+        }
+
+        auto&& entry = *std::min_element(std::begin(entries), std::end(entries),
+            [](Entry const& a, Entry const& b){ return a.last_use < b.last_use; });
+        entry = Entry{key, std::move(value), ++time};
+        return entry.value;
+    }
+
+    size_t size() const { return entries.size(); }
+
+    void clear() { entries.clear(); }
+
+private:
+
+    struct Entry
+    {
+        Key key;
+        Value value;
+        uint64_t last_use;
+    };
+
+    size_t capacity;
+
+    uint64_t time;
+
+    std::vector<Entry> entries;
+};
+
+} // namespace pink
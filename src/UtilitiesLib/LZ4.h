@@ -0,0 +1,173 @@
+/**
+ * @file   UtilitiesLib/LZ4.h
+ * @brief  Compression and decompression of the LZ4 block format.
+ *
+ * The blocks are compatible with the reference implementation (LZ4_compress_default,
+ * LZ4_decompress_safe). The compressor uses a single hash table and greedy matching,
+ * which is sufficient for the very redundant data of sparse images.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "pink_exception.h"
+
+namespace pink {
+
+namespace lz4 {
+
+/// Minimal length of a match
+static const size_t min_match = 4;
+
+/// The last bytes of a block are always literals
+static const size_t last_literals = 5;
+
+/// The last match must start before this distance to the end of a block
+static const size_t match_find_limit = 12;
+
+static const size_t max_offset = 65535;
+
+static const int hash_log = 16;
+
+inline uint32_t read32(unsigned char const *p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(uint32_t));
+    return v;
+}
+
+inline uint32_t hash(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - hash_log);
+}
+
+/// Writes the remainder of a length larger than 14 as sequence of bytes
+inline void write_length(std::vector<char>& dst, size_t length)
+{
+    for (; length >= 255; length -= 255) dst.push_back(static_cast<char>(255));
+    dst.push_back(static_cast<char>(length));
+}
+
+inline void write_sequence(std::vector<char>& dst, unsigned char const *literals, size_t literal_length,
+    size_t offset, size_t match_length)
+{
+    bool last = match_length == 0;
+    size_t ml = last ? 0 : match_length - min_match;
+
+    dst.push_back(static_cast<char>(((literal_length < 15 ? literal_length : 15) << 4) | (ml < 15 ? ml : 15)));
+    if (literal_length >= 15) write_length(dst, literal_length - 15);
+    dst.insert(dst.end(), literals, literals + literal_length);
+    if (last) return;
+
+    dst.push_back(static_cast<char>(offset & 0xff));
+    dst.push_back(static_cast<char>(offset >> 8));
+    if (ml >= 15) write_length(dst, ml - 15);
+}
+
+} // namespace lz4
+
+/// Maximal size of a compressed block
+inline size_t lz4_compress_bound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+/// Compresses size bytes into a single LZ4 block
+inline std::vector<char> lz4_compress(char const *source, size_t size)
+{
+    using namespace lz4;
+
+    auto&& src = reinterpret_cast<unsigned char const*>(source);
+    std::vector<char> dst;
+    dst.reserve(lz4_compress_bound(size));
+
+    size_t anchor = 0;
+    if (size > match_find_limit) {
+        // Positions + 1, zero is empty
+        std::vector<uint32_t> table(1 << hash_log, 0);
+        size_t match_limit = size - last_literals;
+
+        for (size_t ip = 0; ip + match_find_limit <= size;) {
+            uint32_t sequence = read32(src + ip);
+            uint32_t& entry = table[hash(sequence)];
+            size_t candidate = entry;
+            entry = ip + 1;
+
+            if (candidate == 0 or ip - (candidate - 1) > max_offset or read32(src + candidate - 1) != sequence) {
+                ++ip;
+                continue;
+            }
+
+            size_t ref = candidate - 1;
+            size_t length = min_match;
+            while (ip + length < match_limit and src[ref + length] == src[ip + length]) ++length;
+
+            write_sequence(dst, src + anchor, ip - anchor, ip - ref, length);
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    write_sequence(dst, src + anchor, size - anchor, 0, 0);
+    return dst;
+}
+
+/// Decompresses a LZ4 block, which must result exactly in size bytes
+inline void lz4_decompress(char const *source, size_t source_size, char *destination, size_t size)
+{
+    using namespace lz4;
+
+    auto&& src = reinterpret_cast<unsigned char const*>(source);
+    auto&& dst = reinterpret_cast<unsigned char*>(destination);
+
+    auto&& read_length = [&](size_t& ip, size_t& length) {
+        unsigned char b;
+        do {
+            if (ip >= source_size) throw pink::exception("lz4_decompress: corrupted block");
+            b = src[ip++];
+            length += b;
+        } while (b == 255);
+    };
+
+    size_t ip = 0, op = 0;
+    for (;;) {
+        if (ip >= source_size) throw pink::exception("lz4_decompress: corrupted block");
+        unsigned char token = src[ip++];
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15) read_length(ip, literal_length);
+        if (literal_length > source_size - ip or literal_length > size - op)
+            throw pink::exception("lz4_decompress: corrupted block");
+        std::memcpy(dst + op, src + ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        // The last sequence contains only literals
+        if (ip == source_size) break;
+
+        if (ip + 2 > source_size) throw pink::exception("lz4_decompress: corrupted block");
+        size_t offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 or offset > op) throw pink::exception("lz4_decompress: corrupted block");
+
+        size_t match_length = token & 15;
+        if (match_length == 15) read_length(ip, match_length);
+        match_length += min_match;
+        if (match_length > size - op) throw pink::exception("lz4_decompress: corrupted block");
+
+        // Matches may overlap with the output
+        unsigned char const *match = dst + op - offset;
+        for (size_t i = 0; i < match_length; ++i) dst[op + i] = match[i];
+        op += match_length;
+    }
+
+    if (op != size) throw pink::exception("lz4_decompress: size of decompressed block does not match");
+}
+
+} // namespace pink
@@ -0,0 +1,87 @@
+/**
+ * @file   UtilitiesLib/MemoryMappedFile.h
+ * @brief  Read-only memory mapping of a whole file.
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pink_exception.h"
+
+namespace pink {
+
+/// Maps a file read-only into the address space, which is released at destruction
+class MemoryMappedFile
+{
+public:
+
+    explicit MemoryMappedFile(std::string const& filename)
+     : ptr(nullptr),
+       length(0)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd == -1) throw pink::exception("Error opening " + filename);
+
+        struct stat sb;
+        if (::fstat(fd, &sb) == -1) {
+            ::close(fd);
+            throw pink::exception("Error reading file size of " + filename);
+        }
+        length = sb.st_size;
+
+        if (length != 0) {
+            void *p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw pink::exception("Error mapping " + filename);
+            }
+            ptr = static_cast<char const*>(p);
+        }
+
+        // The mapping remains valid after closing the file descriptor
+        ::close(fd);
+    }
+
+    ~MemoryMappedFile()
+    {
+        if (ptr) ::munmap(const_cast<char*>(ptr), length);
+    }
+
+    MemoryMappedFile(MemoryMappedFile const&) = delete;
+    MemoryMappedFile& operator = (MemoryMappedFile const&) = delete;
+
+    /// Advise the kernel about the access pattern of the byte range [offset, offset + size).
+    /// The range is extended to page boundaries. Failures are ignored, as it is only a hint.
+    void advise(size_t offset, size_t size, int advice) const
+    {
+        if (!ptr or size == 0) return;
+        static const size_t page_size = ::sysconf(_SC_PAGESIZE);
+        size_t begin = offset / page_size * page_size;
+        size_t end = std::min(offset + size, length);
+        if (begin >= end) return;
+        ::madvise(const_cast<char*>(ptr) + begin, end - begin, advice);
+    }
+
+    char const* data() const { return ptr; }
+
+    size_t size() const { return length; }
+
+private:
+
+    char const *ptr;
+
+    size_t length;
+
+};
+
+} // namespace pink
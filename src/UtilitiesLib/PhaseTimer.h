@@ -0,0 +1,219 @@
+/**
+ * @file   UtilitiesLib/PhaseTimer.h
+ * @brief  Accumulated times of the processing phases for each thread.
+ *
+ * The scoped timers are no-ops until the registry is enabled, e.g. by --metrics-file.
+ * Nested timers are ignored, so that each time interval is counted only once
+ * for the outermost phase of the thread.
+ *
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace pink {
+
+enum class Phase : int {
+    IO,
+    ROTATION,
+    DISTANCE,
+    BEST_MATCH,
+    UPDATE,
+    OUTPUT
+};
+
+static const int number_of_phases = 6;
+
+inline char const* get_phase_name(Phase phase)
+{
+    static char const* names[number_of_phases] = {"io", "rotation", "distance", "best_match", "update", "output"};
+    return names[static_cast<int>(phase)];
+}
+
+/// Accumulated times of a single thread, the atomics allow reading by the reporting thread
+struct PhaseTimes
+{
+    PhaseTimes()
+    {
+        for (auto&& t : nanoseconds) t = 0;
+        for (auto&& c : calls) c = 0;
+    }
+
+    std::array<std::atomic<uint64_t>, number_of_phases> nanoseconds;
+    std::array<std::atomic<uint64_t>, number_of_phases> calls;
+};
+
+/// Process-wide collection of the phase times of all threads
+class PhaseTimerRegistry
+{
+public:
+
+    static PhaseTimerRegistry& instance()
+    {
+        static PhaseTimerRegistry registry;
+        return registry;
+    }
+
+    void enable(bool value = true)
+    {
+        enabled.store(value, std::memory_order_relaxed);
+    }
+
+    bool is_enabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the times of the calling thread, which are registered at the first call.
+    /// The times are kept after the thread has finished.
+    PhaseTimes& get_thread_times()
+    {
+        thread_local PhaseTimes *times = nullptr;
+        if (times == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.emplace_back(new PhaseTimes);
+            times = threads.back().get();
+        }
+        return *times;
+    }
+
+    /// Sets all times to zero and restarts the elapsed time
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto&& times : threads) {
+            for (auto&& t : times->nanoseconds) t = 0;
+            for (auto&& c : times->calls) c = 0;
+        }
+        start_time = std::chrono::steady_clock::now();
+    }
+
+    /// Writes the sum over all threads and the times of each thread as single-line JSON object.
+    /// Threads without any timed phase are skipped.
+    void write_json(std::ostream& os, std::string const& event, uint64_t processed_entries) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        std::array<uint64_t, number_of_phases> total_nanoseconds{}, total_calls{};
+        for (auto&& times : threads) {
+            for (int p = 0; p != number_of_phases; ++p) {
+                total_nanoseconds[p] += times->nanoseconds[p];
+                total_calls[p] += times->calls[p];
+            }
+        }
+
+        os << "{\"event\": \"" << event << "\", \"elapsed_seconds\": " << elapsed
+           << ", \"processed_entries\": " << processed_entries
+           << ", \"entries_per_second\": " << (elapsed > 0.0 ? processed_entries / elapsed : 0.0)
+           << ", \"phases\": ";
+        write_phases(os, total_nanoseconds, total_calls);
+
+        os << ", \"threads\": [";
+        bool first = true;
+        for (size_t i = 0; i != threads.size(); ++i) {
+            std::array<uint64_t, number_of_phases> nanoseconds, calls;
+            uint64_t sum = 0;
+            for (int p = 0; p != number_of_phases; ++p) {
+                nanoseconds[p] = threads[i]->nanoseconds[p];
+                calls[p] = threads[i]->calls[p];
+                sum += calls[p];
+            }
+            if (sum == 0) continue;
+            if (!first) os << ", ";
+            first = false;
+            os << "{\"thread\": " << i << ", \"phases\": ";
+            write_phases(os, nanoseconds, calls);
+            os << "}";
+        }
+        os << "]}" << std::endl;
+    }
+
+private:
+
+    PhaseTimerRegistry()
+     : enabled(false),
+       start_time(std::chrono::steady_clock::now())
+    {}
+
+    static void write_phases(std::ostream& os, std::array<uint64_t, number_of_phases> const& nanoseconds,
+        std::array<uint64_t, number_of_phases> const& calls)
+    {
+        os << "{";
+        for (int p = 0; p != number_of_phases; ++p) {
+            if (p != 0) os << ", ";
+            os << "\"" << get_phase_name(static_cast<Phase>(p)) << "\": {\"seconds\": " << nanoseconds[p] * 1e-9
+               << ", \"calls\": " << calls[p] << "}";
+        }
+        os << "}";
+    }
+
+    std::atomic<bool> enabled;
+
+    mutable std::mutex mutex;
+
+    std::vector<std::unique_ptr<PhaseTimes>> threads;
+
+    std::chrono::steady_clock::time_point start_time;
+};
+
+/// Adds the lifetime of the object to the phase of the calling thread
+class ScopedPhaseTimer
+{
+public:
+
+    explicit ScopedPhaseTimer(Phase phase)
+     : phase(phase),
+       times(nullptr)
+    {
+        auto&& registry = PhaseTimerRegistry::instance();
+        if (!registry.is_enabled() or is_active()) return;
+
+        times = &registry.get_thread_times();
+        is_active() = true;
+        start_time = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedPhaseTimer()
+    {
+        if (times == nullptr) return;
+
+        auto&& duration = std::chrono::steady_clock::now() - start_time;
+        int p = static_cast<int>(phase);
+        times->nanoseconds[p].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+            std::memory_order_relaxed);
+        times->calls[p].fetch_add(1, std::memory_order_relaxed);
+        is_active() = false;
+    }
+
+    ScopedPhaseTimer(ScopedPhaseTimer const&) = delete;
+    ScopedPhaseTimer& operator = (ScopedPhaseTimer const&) = delete;
+
+private:
+
+    /// True if a timer of the calling thread is running
+    static bool& is_active()
+    {
+        thread_local bool active = false;
+        return active;
+    }
+
+    Phase phase;
+
+    PhaseTimes *times;
+
+    std::chrono::steady_clock::time_point start_time;
+};
+
+} // namespace pink
@@ -23,7 +23,7 @@ public:
     void operator ++ ()
     {
         ++ticks;
-        if (valid())
+        if (ticks == next_progress_print)
         {
             ++progress;
             next_progress_print = (progress+1) * total / number_of_progress_prints;
@@ -46,9 +46,19 @@ public:
         }
     }
 
+    /// Skips the ticks of an interrupted run without printing
+    void set_ticks(int new_ticks)
+    {
+        ticks = new_ticks;
+        progress = 0;
+        while ((progress+1) * total / number_of_progress_prints <= ticks and progress < number_of_progress_prints) ++progress;
+        next_progress_print = (progress+1) * total / number_of_progress_prints;
+    }
+
+    /// Returns true if the last tick reached a progress step
     bool valid () const
     {
-        return ticks == next_progress_print;
+        return progress != 0 and ticks == progress * total / number_of_progress_prints;
     }
 
 private:
@@ -0,0 +1,47 @@
+/**
+ * @file   UtilitiesLib/SIMDLevel.h
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <ostream>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(__CUDACC__)
+    #define PINK_USE_X86_SIMD
+#endif
+
+namespace pink {
+
+//! Vector instruction set used by the CPU kernels
+enum class SIMDLevel {
+    SCALAR,
+    AVX2,
+    AVX512
+};
+
+//! Returns the best instruction set supported by the running CPU, detected once at first call
+inline SIMDLevel get_simd_level()
+{
+#ifdef PINK_USE_X86_SIMD
+    static const SIMDLevel level = __builtin_cpu_supports("avx512f") ? SIMDLevel::AVX512
+                                 : (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma")) ? SIMDLevel::AVX2
+                                 : SIMDLevel::SCALAR;
+    return level;
+#else
+    return SIMDLevel::SCALAR;
+#endif
+}
+
+//! Pretty printing of SIMDLevel
+inline std::ostream& operator << (std::ostream& os, SIMDLevel level)
+{
+    if (level == SIMDLevel::SCALAR) os << "scalar";
+    else if (level == SIMDLevel::AVX2) os << "avx2";
+    else if (level == SIMDLevel::AVX512) os << "avx512";
+    else os << "undefined";
+    return os;
+}
+
+} // namespace pink
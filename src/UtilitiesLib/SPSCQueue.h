@@ -0,0 +1,177 @@
+/**
+ * @file   UtilitiesLib/SPSCQueue.h
+ * @brief  Bounded lock-free queue for a single producer and a single consumer.
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+    #include <ctime>
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace pink {
+
+/// Bounded ring buffer, which can be used by one producer and one consumer thread without locks.
+/// The producer closes the queue after the last element. Waiting threads spin for a short time
+/// and then sleep on a futex, so that a stage waiting for a slow one (e.g. for I/O) does not burn
+/// a core. Each push, pop, and close wakes a sleeping thread. As the cancel condition is polled,
+/// @notify must be called after it is set, to wake up a sleeping thread immediately.
+template <typename T>
+class SPSCQueue
+{
+public:
+
+    /// Number of attempts before a waiting thread sleeps
+    static const int spin_count = 1000;
+
+    /// Maximal sleeping time in nanoseconds before the cancel condition is checked again
+    static const long sleep_timeout = 10000000;
+
+    explicit SPSCQueue(size_t capacity)
+     : buffer(capacity + 1),
+       head(0),
+       tail(0),
+       closed(false),
+       events(0),
+       sleepers(0)
+    {}
+
+    SPSCQueue(SPSCQueue const&) = delete;
+    SPSCQueue& operator = (SPSCQueue const&) = delete;
+
+    /// Returns false if the queue is full
+    bool try_push(T& value)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = increment(t);
+        if (next == head.load(std::memory_order_acquire)) return false;
+        buffer[t] = std::move(value);
+        tail.store(next, std::memory_order_release);
+        notify();
+        return true;
+    }
+
+    /// Returns false if the queue is empty
+    bool try_pop(T& value)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        value = std::move(buffer[h]);
+        head.store(increment(h), std::memory_order_release);
+        notify();
+        return true;
+    }
+
+    /// Waits until the value is pushed or cancel returns true. Returns false if cancelled.
+    template <typename Cancel>
+    bool push(T& value, Cancel const& cancel)
+    {
+        return wait([&](){ return try_push(value); }, cancel);
+    }
+
+    /// Waits for the next value. Returns false if the queue is closed and empty or cancel returns true.
+    template <typename Cancel>
+    bool pop(T& value, Cancel const& cancel)
+    {
+        bool popped = false;
+        if (!wait([&](){ return (popped = try_pop(value)) or closed.load(std::memory_order_acquire); }, cancel)) return false;
+
+        // The last value may be pushed before closing
+        return popped or try_pop(value);
+    }
+
+    /// No further values will be pushed
+    void close()
+    {
+        closed.store(true, std::memory_order_release);
+        notify();
+    }
+
+    /// Wakes up a sleeping thread, e.g. after the cancel condition is set
+    void notify()
+    {
+        events.fetch_add(1);
+        if (sleepers.load() != 0) wake(events);
+    }
+
+private:
+
+    size_t increment(size_t i) const { return i + 1 == buffer.size() ? 0 : i + 1; }
+
+    /// Waits until ready returns true (result true) or cancel returns true (result false)
+    template <typename Ready, typename Cancel>
+    bool wait(Ready const& ready, Cancel const& cancel)
+    {
+        for (int i = 0; i < spin_count; ++i) {
+            if (ready()) return true;
+        }
+
+        while (true) {
+            // An event after the registration as sleeper changes the futex value or wakes the thread
+            sleepers.fetch_add(1);
+            uint32_t current_events = events.load();
+            bool is_ready = ready();
+            bool is_cancelled = !is_ready and cancel();
+            if (!is_ready and !is_cancelled) sleep(events, current_events);
+            sleepers.fetch_sub(1);
+
+            if (is_ready or ready()) return true;
+            if (is_cancelled or cancel()) return false;
+        }
+    }
+
+    /// Sleeps while word has the expected value, at most for sleep_timeout
+    static void sleep(std::atomic<uint32_t>& word, uint32_t expected)
+    {
+#ifdef __linux__
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Futex needs a plain 32 bit word");
+        timespec timeout{0, sleep_timeout};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, &timeout, nullptr, 0);
+#else
+        static_cast<void>(word);
+        static_cast<void>(expected);
+        std::this_thread::yield();
+#endif
+    }
+
+    /// Wakes up all threads sleeping on word
+    static void wake(std::atomic<uint32_t>& word)
+    {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+        static_cast<void>(word);
+#endif
+    }
+
+    std::vector<T> buffer;
+
+    /// Position of the next value to pop, only written by the consumer
+    alignas(64) std::atomic<size_t> head;
+
+    /// Position of the next value to push, only written by the producer
+    alignas(64) std::atomic<size_t> tail;
+
+    std::atomic<bool> closed;
+
+    /// Counter of all events, which is used as futex word
+    std::atomic<uint32_t> events;
+
+    /// Number of waiting threads, which may sleep
+    std::atomic<int> sleepers;
+};
+
+} // namespace pink
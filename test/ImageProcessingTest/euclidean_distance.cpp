@@ -0,0 +1,91 @@
+/**
+ * @file   ImageProcessingTest/euclidean_distance.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "ImageProcessingLib/euclidean_distance.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+namespace {
+
+double reference_distance_square_offset(float const *a, float const *b, int image_dim, int euclidean_distance_dim)
+{
+    int offset = (image_dim - euclidean_distance_dim) / 2;
+    double sum = 0.0;
+    for (int i = offset; i < offset + euclidean_distance_dim; ++i) {
+        for (int j = offset; j < offset + euclidean_distance_dim; ++j) {
+            double diff = static_cast<double>(a[i * image_dim + j]) - b[i * image_dim + j];
+            sum += diff * diff;
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+class EuclideanDistanceTest : public ::testing::TestWithParam<std::pair<int, int>>
+{};
+
+TEST_P(EuclideanDistanceTest, offset)
+{
+    int image_dim = GetParam().first;
+    int euclidean_distance_dim = GetParam().second;
+
+    std::vector<float> a(image_dim * image_dim), b(image_dim * image_dim);
+    fill_random_uniform(&a[0], a.size(), 1);
+    fill_random_uniform(&b[0], b.size(), 2);
+
+    double est = reference_distance_square_offset(&a[0], &b[0], image_dim, euclidean_distance_dim);
+    double tolerance = 1e-5 * est + 1e-6;
+
+    EXPECT_NEAR(est, euclidean_distance_square_offset_scalar(&a[0], &b[0], image_dim, euclidean_distance_dim), tolerance);
+    EXPECT_NEAR(est, euclidean_distance_square_offset(&a[0], &b[0], image_dim, euclidean_distance_dim), tolerance);
+
+#ifdef PINK_USE_X86_SIMD
+    if (get_simd_level() >= SIMDLevel::AVX2) {
+        EXPECT_NEAR(est, euclidean_distance_square_offset_avx2(&a[0], &b[0], image_dim, euclidean_distance_dim), tolerance);
+    }
+    if (get_simd_level() >= SIMDLevel::AVX512) {
+        EXPECT_NEAR(est, euclidean_distance_square_offset_avx512(&a[0], &b[0], image_dim, euclidean_distance_dim), tolerance);
+    }
+#endif
+}
+
+INSTANTIATE_TEST_CASE_P(EuclideanDistanceTest_all, EuclideanDistanceTest,
+    ::testing::Values(
+        std::make_pair(1, 1),
+        std::make_pair(3, 2),
+        std::make_pair(8, 8),
+        std::make_pair(17, 11),
+        std::make_pair(44, 31),
+        std::make_pair(64, 45),
+        std::make_pair(101, 71)
+));
+
+TEST(EuclideanDistanceTest, contiguous)
+{
+    for (int length : {0, 1, 7, 8, 15, 16, 33, 1000}) {
+        std::vector<float> a(length + 1), b(length + 1);
+        fill_random_uniform(&a[0], a.size(), 1);
+        fill_random_uniform(&b[0], b.size(), 2);
+
+        float est = euclidean_distance_square_scalar(&a[0], &b[0], length);
+        EXPECT_NEAR(est, euclidean_distance_square(&a[0], &b[0], length), 1e-5 * est + 1e-6);
+    }
+}
+
+TEST(EuclideanDistanceTest, integer)
+{
+    std::vector<int> a{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<int> b{9, 8, 7, 6, 5, 4, 3, 2, 1};
+
+    EXPECT_EQ(0, euclidean_distance_square_offset(&a[0], &b[0], 3, 0));
+    EXPECT_EQ(0, euclidean_distance_square_offset(&a[0], &b[0], 3, 1));
+    EXPECT_EQ(240, euclidean_distance_square_offset(&a[0], &b[0], 3, 3));
+}
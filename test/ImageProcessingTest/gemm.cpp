@@ -0,0 +1,68 @@
+/**
+ * @file   ImageProcessingTest/gemm.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <gtest/gtest.h>
+#include <tuple>
+#include <vector>
+
+#include "ImageProcessingLib/gemm.h"
+#include "UtilitiesLib/EqualFloatArrays.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+class GemmTest : public ::testing::TestWithParam<std::tuple<int, int, int>>
+{};
+
+TEST_P(GemmTest, compare_with_naive)
+{
+    int m = std::get<0>(GetParam());
+    int n = std::get<1>(GetParam());
+    int k = std::get<2>(GetParam());
+
+    std::vector<float> a(m * k), b(n * k), c(m * n), est(m * n);
+    fill_random_uniform(&a[0], a.size(), 1);
+    fill_random_uniform(&b[0], b.size(), 2);
+
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+            double sum = 0.0;
+            for (int p = 0; p < k; ++p) sum += static_cast<double>(a[i * k + p]) * b[j * k + p];
+            est[i * n + j] = sum;
+        }
+    }
+
+    gemm_nt(&a[0], &b[0], &c[0], m, n, k);
+    EXPECT_TRUE(EqualFloatArrays(est, c, 1e-5 * k));
+
+    std::vector<float> c_scalar(m * n);
+    gemm_nt_parallel(&c_scalar[0], m, n, k, [&](int i0, int j0, int p0, int mc, int nc, int kc) {
+        gemm_nt_block<4, 4>(&a[i0 * k + p0], &b[j0 * k + p0], &c_scalar[i0 * n + j0], mc, nc, kc, k, k, n,
+            gemm_nt_micro_kernel_scalar<4, 4, float>, gemm_nt_micro_kernel_scalar<1, 1, float>);
+    });
+    EXPECT_TRUE(EqualFloatArrays(est, c_scalar, 1e-5 * k));
+}
+
+INSTANTIATE_TEST_CASE_P(GemmTest_all, GemmTest,
+    ::testing::Values(
+        std::make_tuple(1, 1, 1),
+        std::make_tuple(3, 4, 8),
+        std::make_tuple(5, 7, 13),
+        std::make_tuple(49, 65, 17),
+        std::make_tuple(100, 72, 961),
+        std::make_tuple(7, 130, 2100)
+));
+
+TEST(GemmTest, integer)
+{
+    std::vector<int> a{1, 2, 3, 4, 5, 6};
+    std::vector<int> b{1, 0, 1, 0, 1, 0};
+    std::vector<int> c(4);
+
+    gemm_nt(&a[0], &b[0], &c[0], 2, 2, 3);
+
+    EXPECT_EQ((std::vector<int>{4, 2, 10, 5}), c);
+}
@@ -9,8 +9,10 @@
 #include <vector>
 
 #include "ImageProcessingLib/rotate.h"
+#include "ImageProcessingLib/rotate_90_degrees.h"
 #include "ImageProcessingLib/rotate_and_crop.h"
 #include "UtilitiesLib/EqualFloatArrays.h"
+#include "UtilitiesLib/Filler.h"
 
 using namespace pink;
 
@@ -82,3 +84,43 @@ TEST(RotationTest, compare_with_crop)
 
     EXPECT_TRUE(EqualFloatArrays(dst_crop, dst, 1e-4));
 }
+
+TEST(RotationTest, rotate_bilinear_vectorized)
+{
+    for (int src_dim : {1, 2, 9, 45, 64}) {
+        for (int dst_dim : {1, 3, 8, 13, 45, 64}) {
+            std::vector<float> src(src_dim * src_dim);
+            fill_random_uniform(&src[0], src.size(), src_dim);
+
+            for (float alpha : {0.0, 0.1, 0.25 * M_PI, 1.0, 0.5 * M_PI, 3.0, 5.0}) {
+                std::vector<float> est(dst_dim * dst_dim, 42.0);
+                std::vector<float> dst(dst_dim * dst_dim, 42.0);
+
+                rotate_bilinear(&src[0], &est[0], src_dim, src_dim, dst_dim, dst_dim, alpha);
+                rotate_bilinear_vectorized(&src[0], &dst[0], src_dim, src_dim, dst_dim, dst_dim, alpha);
+
+                EXPECT_EQ(est, dst) << "src_dim = " << src_dim << ", dst_dim = " << dst_dim << ", alpha = " << alpha;
+            }
+        }
+    }
+}
+
+TEST(RotationTest, rotate_90_degrees_tiled)
+{
+    for (int height : {1, 5, 16, 17, 64}) {
+        for (int width : {1, 7, 16, 33}) {
+            std::vector<float> src(height * width);
+            fill_random_uniform(&src[0], src.size(), height * width);
+
+            std::vector<float> est(height * width);
+            std::vector<float> dst(height * width);
+
+            rotate_90_degrees_untiled(&src[0], &est[0], height, width);
+            rotate_90_degrees_tiled<16>(&src[0], &dst[0], height, width);
+            EXPECT_EQ(est, dst);
+
+            rotate_90_degrees_tiled<4>(&src[0], &dst[0], height, width);
+            EXPECT_EQ(est, dst);
+        }
+    }
+}
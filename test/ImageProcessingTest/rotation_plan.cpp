@@ -0,0 +1,57 @@
+/**
+ * @file   ImageProcessingTest/rotation_plan.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "ImageProcessingLib/rotate.h"
+#include "ImageProcessingLib/rotation_plan.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+TEST(RotationPlanTest, compare_with_rotate_bilinear)
+{
+    for (int src_dim : {1, 2, 7, 16, 45}) {
+        for (int dst_dim : {1, 3, 16, 32, 64}) {
+            std::vector<float> src(src_dim * src_dim);
+            fill_random_uniform(&src[0], src.size(), src_dim);
+
+            for (float alpha : {0.0, 0.1, 0.25 * M_PI, 1.0, 0.5 * M_PI, 3.0}) {
+                std::vector<float> est(dst_dim * dst_dim, 42.0);
+                std::vector<float> dst(dst_dim * dst_dim, 42.0);
+
+                rotate_bilinear(&src[0], &est[0], src_dim, src_dim, dst_dim, dst_dim, alpha);
+                BilinearRotationPlan plan(src_dim, src_dim, dst_dim, dst_dim, alpha);
+                plan(&src[0], &dst[0]);
+
+                EXPECT_EQ(est, dst) << "src_dim = " << src_dim << ", dst_dim = " << dst_dim << ", alpha = " << alpha;
+            }
+        }
+    }
+}
+
+TEST(RotationPlanTest, rectangular_and_integer)
+{
+    int src_height = 5, src_width = 8, dst_height = 6, dst_width = 4;
+    std::vector<int> src(src_height * src_width);
+    fill_random_uniform(&src[0], src.size(), 1);
+    for (auto&& e : src) e %= 1000;
+
+    for (float alpha : {0.0, 0.3, 2.0}) {
+        std::vector<int> est(dst_height * dst_width);
+        std::vector<int> dst(dst_height * dst_width);
+
+        rotate_bilinear(&src[0], &est[0], src_height, src_width, dst_height, dst_width, alpha);
+        BilinearRotationPlan plan(src_height, src_width, dst_height, dst_width, alpha);
+        plan(&src[0], &dst[0]);
+
+        EXPECT_EQ(est, dst);
+        EXPECT_EQ(static_cast<size_t>(src_height * src_width), plan.get_src_size());
+        EXPECT_EQ(static_cast<size_t>(dst_height * dst_width), plan.get_dst_size());
+    }
+}
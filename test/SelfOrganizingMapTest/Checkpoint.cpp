@@ -0,0 +1,173 @@
+/**
+ * @file   SelfOrganizingMapTest/Checkpoint.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "SelfOrganizingMapLib/CartesianLayout.h"
+#include "SelfOrganizingMapLib/Checkpoint.h"
+#include "SelfOrganizingMapLib/Data.h"
+#include "SelfOrganizingMapLib/DataIterator.h"
+#include "SelfOrganizingMapLib/SOM.h"
+#include "SelfOrganizingMapLib/Trainer.h"
+#include "UtilitiesLib/DistributionFunctor.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+TEST(CheckpointTest, write_and_read)
+{
+    Checkpoint<float> checkpoint;
+    checkpoint.iteration = 2;
+    checkpoint.position = 17;
+    checkpoint.number_of_entries = 100;
+    checkpoint.seed = 1234;
+    checkpoint.shuffle_block_size = 8;
+    checkpoint.shuffle_buffer_size = 64;
+    checkpoint.intermediate_storage_count = 3;
+    checkpoint.som_dimension = {2, 3};
+    checkpoint.neuron_dimension = {4, 4};
+    checkpoint.som_data.resize(2 * 3 * 4 * 4);
+    fill_random_uniform(&checkpoint.som_data[0], checkpoint.som_data.size(), 1);
+    checkpoint.update_info = {1, 2, 3, 4, 5, 6};
+
+    std::string filename = "CheckpointTest_write_and_read.bin";
+    {
+        // Two snapshots in the background, the last one is kept
+        CheckpointWriter<float> writer(filename);
+        Checkpoint<float> first = checkpoint;
+        first.position = 0;
+        writer.write(std::move(first));
+        Checkpoint<float> second = checkpoint;
+        writer.write(std::move(second));
+    }
+
+    auto&& result = read_checkpoint<float>(filename);
+    EXPECT_EQ(checkpoint.iteration, result.iteration);
+    EXPECT_EQ(checkpoint.position, result.position);
+    EXPECT_EQ(checkpoint.number_of_entries, result.number_of_entries);
+    EXPECT_EQ(checkpoint.seed, result.seed);
+    EXPECT_EQ(checkpoint.shuffle_block_size, result.shuffle_block_size);
+    EXPECT_EQ(checkpoint.shuffle_buffer_size, result.shuffle_buffer_size);
+    EXPECT_EQ(checkpoint.intermediate_storage_count, result.intermediate_storage_count);
+    EXPECT_EQ(checkpoint.som_dimension, result.som_dimension);
+    EXPECT_EQ(checkpoint.neuron_dimension, result.neuron_dimension);
+    EXPECT_EQ(checkpoint.som_data, result.som_data);
+    EXPECT_EQ(checkpoint.update_info, result.update_info);
+
+    // Truncated file
+    {
+        std::ofstream os(filename, std::ios::binary | std::ios::trunc);
+        std::vector<int> header{2, 6, 0, 1};
+        os.write(reinterpret_cast<char const*>(&header[0]), header.size() * sizeof(int));
+    }
+    EXPECT_THROW(read_checkpoint<float>(filename), pink::exception);
+
+    std::remove(filename.c_str());
+}
+
+TEST(CheckpointTest, not_a_checkpoint)
+{
+    std::string filename = "CheckpointTest_not_a_checkpoint.bin";
+    {
+        std::ofstream os(filename, std::ios::binary);
+        std::vector<int> header{2, 1, 0, 0};
+        os.write(reinterpret_cast<char const*>(&header[0]), header.size() * sizeof(int));
+    }
+    EXPECT_THROW(read_checkpoint<float>(filename), pink::exception);
+
+    // Checkpoint with uint8 data
+    {
+        std::ofstream os(filename, std::ios::binary | std::ios::trunc);
+        std::vector<int> header{2, 6, 6, 0};
+        os.write(reinterpret_cast<char const*>(&header[0]), header.size() * sizeof(int));
+    }
+    EXPECT_THROW(read_checkpoint<float>(filename), pink::exception);
+    std::remove(filename.c_str());
+}
+
+/// The iterator continues with the same entries after setting the position
+TEST(CheckpointTest, iterator_position)
+{
+    uint32_t number_of_entries = 37;
+    std::vector<int> header{2, 0, 0, static_cast<int>(number_of_entries), 0, 2, 2, 2};
+
+    std::stringstream ss;
+    ss.write(reinterpret_cast<char const*>(&header[0]), header.size() * sizeof(int));
+    for (uint32_t i = 0; i != number_of_entries; ++i) {
+        std::vector<float> values{static_cast<float>(i), 0.0f, 0.0f, 0.0f};
+        ss.write(reinterpret_cast<char const*>(&values[0]), values.size() * sizeof(float));
+    }
+
+    for (uint32_t block_size : {0U, 4U}) {
+        DataIterator<CartesianLayout<2>, float> iter(ss, 5ul, block_size, 8);
+        DataIterator<CartesianLayout<2>, float> end(ss, true);
+
+        std::vector<float> reference;
+        for (; iter != end; ++iter) reference.push_back(iter->get_data_pointer()[0]);
+        ASSERT_EQ(number_of_entries, reference.size());
+
+        for (uint32_t position : {0U, 1U, 13U, 36U, 37U}) {
+            iter.set_to_position(position);
+            std::vector<float> result;
+            for (; iter != end; ++iter) result.push_back(iter->get_data_pointer()[0]);
+            EXPECT_EQ(std::vector<float>(reference.begin() + position, reference.end()), result);
+        }
+    }
+}
+
+/// Training with a restored SOM and update information gives the same result as uninterrupted training
+TEST(CheckpointTest, resume_training)
+{
+    typedef Data<CartesianLayout<2>, float> DataType;
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Trainer<CartesianLayout<2>, CartesianLayout<2>, float, false> MyTrainer;
+
+    uint32_t som_dim = 3;
+    uint32_t image_dim = 6;
+    uint32_t neuron_dim = 4;
+    uint32_t number_of_images = 6;
+
+    std::vector<DataType> images;
+    for (uint32_t i = 0; i < number_of_images; ++i) {
+        std::vector<float> v(image_dim * image_dim);
+        fill_random_uniform(&v[0], v.size(), i);
+        images.push_back(DataType({image_dim, image_dim}, v));
+    }
+
+    std::vector<float> init(som_dim * som_dim * neuron_dim * neuron_dim);
+    fill_random_uniform(&init[0], init.size(), 42);
+
+    auto&& f = GaussianFunctor(1.1, 0.2);
+
+    SOMType som1({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+    MyTrainer trainer1(som1, f, 0, 4, true, 1.5, Interpolation::BILINEAR);
+    for (auto&& image : images) trainer1(image);
+
+    SOMType som2({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+    Checkpoint<float> checkpoint;
+    {
+        MyTrainer trainer2(som2, f, 0, 4, true, 1.5, Interpolation::BILINEAR);
+        for (uint32_t i = 0; i != number_of_images / 2; ++i) trainer2(images[i]);
+
+        checkpoint.som_data.assign(som2.get_data_pointer(), som2.get_data_pointer() + init.size());
+        auto&& update_info = trainer2.get_update_info();
+        checkpoint.update_info.assign(update_info.get_data_pointer(), update_info.get_data_pointer() + update_info.size());
+    }
+
+    SOMType som3({som_dim, som_dim}, {neuron_dim, neuron_dim}, checkpoint.som_data);
+    MyTrainer trainer3(som3, f, 0, 4, true, 1.5, Interpolation::BILINEAR);
+    trainer3.set_update_info(checkpoint.update_info);
+    for (uint32_t i = number_of_images / 2; i != number_of_images; ++i) trainer3(images[i]);
+
+    EXPECT_EQ(som1, som3);
+    EXPECT_EQ(trainer1.get_update_info(), trainer3.get_update_info());
+    EXPECT_THROW(trainer3.set_update_info(std::vector<uint32_t>(2)), pink::exception);
+}
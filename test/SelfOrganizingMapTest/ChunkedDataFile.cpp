@@ -0,0 +1,125 @@
+/**
+ * @file   SelfOrganizingMapTest/ChunkedDataFile.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "SelfOrganizingMapLib/CartesianLayout.h"
+#include "SelfOrganizingMapLib/ChunkedDataWriter.h"
+#include "SelfOrganizingMapLib/Data.h"
+#include "SelfOrganizingMapLib/DataIterator.h"
+#include "SelfOrganizingMapLib/MmapDataIterator.h"
+
+using namespace pink;
+
+namespace {
+
+typedef Data<CartesianLayout<2>, float> DataType;
+
+/// Sparse 4x5 image, the first value is the index of the entry
+DataType get_entry(int i)
+{
+    std::vector<float> values(20, 0.0f);
+    values[0] = i;
+    values[7 + i % 5] = 0.5f * i;
+    return DataType({4, 5}, values);
+}
+
+void write_chunked(std::ostream& os, int number_of_entries, uint32_t entries_per_chunk)
+{
+    ChunkedDataWriter writer(os, FileDataType::FLOAT32, number_of_entries, {4, 5}, entries_per_chunk);
+    for (int i = 0; i < number_of_entries; ++i) {
+        writer.write(reinterpret_cast<char const*>(get_entry(i).get_data_pointer()));
+    }
+}
+
+} // namespace
+
+TEST(ChunkedDataFileTest, read)
+{
+    for (uint32_t entries_per_chunk : {1, 4, 7, 100}) {
+        for (uint32_t block_size : {0U, entries_per_chunk}) {
+            std::stringstream ss;
+            ss << "# test file\n# END OF HEADER\n";
+            write_chunked(ss, 23, entries_per_chunk);
+
+            DataIterator<CartesianLayout<2>, float> iter(ss, 3ul, block_size, 8);
+            DataIterator<CartesianLayout<2>, float> end(ss, true);
+            EXPECT_EQ(23, iter.get_number_of_entries());
+
+            for (int epoch = 0; epoch < 2; ++epoch) {
+                std::vector<int> entries;
+                for (; iter != end; ++iter) {
+                    int entry = static_cast<int>((*iter)[0]);
+                    EXPECT_EQ(get_entry(entry), *iter);
+                    entries.push_back(entry);
+                }
+                std::sort(entries.begin(), entries.end());
+                std::vector<int> reference(23);
+                std::iota(reference.begin(), reference.end(), 0);
+                EXPECT_EQ(reference, entries);
+
+                iter.set_to_begin();
+            }
+        }
+    }
+}
+
+TEST(ChunkedDataFileTest, same_order_as_uncompressed)
+{
+    std::stringstream ss_chunked, ss_plain;
+    write_chunked(ss_chunked, 30, 4);
+
+    std::vector<int> header{2, 0, 0, 30, 0, 2, 4, 5};
+    ss_plain.write(reinterpret_cast<char const*>(&header[0]), header.size() * sizeof(int));
+    for (int i = 0; i < 30; ++i) {
+        ss_plain.write(reinterpret_cast<char const*>(get_entry(i).get_data_pointer()), 20 * sizeof(float));
+    }
+
+    DataIterator<CartesianLayout<2>, float> iter_chunked(ss_chunked, 5ul, 4, 12);
+    DataIterator<CartesianLayout<2>, float> iter_plain(ss_plain, 5ul, 4, 12);
+    DataIterator<CartesianLayout<2>, float> end(ss_plain, true);
+
+    for (; iter_plain != end; ++iter_plain, ++iter_chunked) {
+        ASSERT_TRUE(iter_chunked != end);
+        EXPECT_EQ(*iter_plain, *iter_chunked);
+    }
+    EXPECT_TRUE(iter_chunked == end);
+}
+
+TEST(ChunkedDataFileTest, compression)
+{
+    std::stringstream ss;
+    write_chunked(ss, 100, 10);
+    EXPECT_LT(ss.str().size() * 4, 100 * 20 * sizeof(float));
+}
+
+TEST(ChunkedDataFileTest, wrong_number_of_entries)
+{
+    std::stringstream ss;
+    ChunkedDataWriter writer(ss, FileDataType::FLOAT32, 1, {4, 5}, 10);
+    EXPECT_THROW(writer.close(), pink::exception);
+}
+
+TEST(ChunkedDataFileTest, not_memory_mapped)
+{
+    std::string filename = "ChunkedDataFileTest_not_memory_mapped.bin";
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        write_chunked(ofs, 10, 4);
+    }
+
+    EXPECT_FALSE((MmapDataIterator<CartesianLayout<2>, float>::is_applicable(filename)));
+    EXPECT_THROW((MmapDataIterator<CartesianLayout<2>, float>(filename)), pink::exception);
+
+    std::remove(filename.c_str());
+}
@@ -11,6 +11,7 @@
 #include "SelfOrganizingMapLib/CartesianLayout.h"
 #include "SelfOrganizingMapLib/HexagonalLayout.h"
 #include "SelfOrganizingMapLib/Data.h"
+#include "SelfOrganizingMapLib/SOM.h"
 
 using namespace pink;
 
@@ -122,3 +123,46 @@ TEST(SelfOrganizingMapTest, data_hexagonal)
     EXPECT_EQ((std::array<uint32_t, 2>{0, 2}), c2.get_layout().get_position(5));
     EXPECT_EQ((std::array<uint32_t, 2>{1, 2}), c2.get_layout().get_position(6));
 }
+
+TEST(SelfOrganizingMapTest, data_without_copy)
+{
+    std::vector<float> v({1, 2, 3, 4});
+    float const *p = v.data();
+
+    // The elements are moved into the data and are accessed by reference
+    Data<CartesianLayout<2>, float> c({2, 2}, std::move(v));
+    EXPECT_EQ(p, c.get_data_pointer());
+    EXPECT_EQ(p, c.get_data().data());
+
+    // The elements of a temporary are moved out
+    auto&& moved = std::move(c).get_data();
+    EXPECT_EQ(p, moved.data());
+}
+
+TEST(SelfOrganizingMapTest, som_without_copy)
+{
+    AlignedVector<float> v({1, 2, 3, 4, 5, 6, 7, 8});
+    float const *p = v.data();
+
+    SOM<CartesianLayout<2>, CartesianLayout<2>, float> som({2, 2}, {1, 2}, std::move(v));
+    EXPECT_EQ(p, som.get_data_pointer());
+    EXPECT_EQ(p, som.get_data().data());
+
+    // The neuron is a view into the SOM
+    auto&& neuron = som.get_neuron({1, 0});
+    EXPECT_EQ(p + 4, neuron.get_data_pointer());
+    EXPECT_EQ(p + 4, neuron.get_data().data());
+    EXPECT_EQ((std::vector<float>{5, 6}), std::vector<float>(neuron.get_data().begin(), neuron.get_data().end()));
+    EXPECT_EQ(6, (neuron[{0, 1}]));
+}
+
+TEST(SelfOrganizingMapTest, som_from_vector_rvalue)
+{
+    std::vector<float> v({1, 2, 3, 4, 5, 6, 7, 8});
+
+    // The elements are copied once into the aligned storage and the temporary is released
+    SOM<CartesianLayout<2>, CartesianLayout<2>, float> som({2, 2}, {1, 2}, std::move(v));
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(0UL, v.capacity());
+    EXPECT_EQ((std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8}), std::vector<float>(som.get_data().begin(), som.get_data().end()));
+}
@@ -12,6 +12,7 @@
 #include "SelfOrganizingMapLib/CartesianLayout.h"
 #include "SelfOrganizingMapLib/Data.h"
 #include "SelfOrganizingMapLib/DataIterator.h"
+#include "UtilitiesLib/pink_exception.h"
 
 using namespace pink;
 
@@ -77,3 +78,56 @@ TEST(DataIteratorTest, cartesian_2d_with_header)
     ++iter;
     EXPECT_EQ((DataIterator<CartesianLayout<2>, float>(ss, true)), iter);
 }
+
+/// Writes 3 images of 2x2 pixels with the values of the data type
+template <typename V>
+void add_reduced_precision_section(std::stringstream& ss, int data_type, std::vector<V> const& values)
+{
+    std::vector<int> header{2, 0, data_type, 3, 0, 2, 2, 2};
+    ss.write(reinterpret_cast<const char*>(&header[0]), header.size() * sizeof(int));
+    ss.write(reinterpret_cast<const char*>(&values[0]), values.size() * sizeof(V));
+}
+
+TEST(DataIteratorTest, reduced_precision)
+{
+    // The first value of each entry is four times the entry index
+    std::vector<float> ref_uint8{0, 1, 2, 3, 4, 5, 6, 7, 8, 255, 0, 1};
+    std::vector<float> ref_uint16{0, 1, 2, 3, 4, 5, 6, 7, 8, 255, 0, 1024};
+    std::vector<float> ref_float16{0, 1, 2, 3, 4, 5, 6, 7, 8, -2, 0.5, 1024};
+
+    for (uint32_t block_size : {0, 2}) {
+        std::stringstream ss_uint8, ss_uint16, ss_float16;
+        add_reduced_precision_section(ss_uint8, 6, std::vector<uint8_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 255, 0, 1});
+        add_reduced_precision_section(ss_uint16, 7, std::vector<uint16_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 255, 0, 1024});
+        add_reduced_precision_section(ss_float16, 10, std::vector<uint16_t>{0x0000, 0x3c00, 0x4000, 0x4200,
+            0x4400, 0x4500, 0x4600, 0x4700, 0x4800, 0xc000, 0x3800, 0x6400});
+
+        DataIterator<CartesianLayout<2>, float> iter_uint8(ss_uint8, 2ul, block_size, 4);
+        DataIterator<CartesianLayout<2>, float> iter_uint16(ss_uint16, 2ul, block_size, 4);
+        DataIterator<CartesianLayout<2>, float> iter_float16(ss_float16, 2ul, block_size, 4);
+        DataIterator<CartesianLayout<2>, float> end(ss_uint8, true);
+
+        auto&& expected = [](std::vector<float> const& ref, float first) {
+            int entry = static_cast<int>(first) / 4;
+            return Data<CartesianLayout<2>, float>({2, 2},
+                std::vector<float>(ref.begin() + entry * 4, ref.begin() + entry * 4 + 4));
+        };
+
+        int count = 0;
+        for (; iter_float16 != end; ++iter_uint8, ++iter_uint16, ++iter_float16, ++count) {
+            ASSERT_TRUE(iter_uint8 != end);
+            ASSERT_TRUE(iter_uint16 != end);
+            EXPECT_EQ(expected(ref_uint8, (*iter_uint8)[0]), *iter_uint8);
+            EXPECT_EQ(expected(ref_uint16, (*iter_uint16)[0]), *iter_uint16);
+            EXPECT_EQ(expected(ref_float16, (*iter_float16)[0]), *iter_float16);
+        }
+        EXPECT_EQ(3, count);
+    }
+}
+
+TEST(DataIteratorTest, unsupported_data_type)
+{
+    std::stringstream ss;
+    add_reduced_precision_section(ss, 1, std::vector<double>(12));
+    EXPECT_THROW((DataIterator<CartesianLayout<2>, float>(ss, 2ul)), pink::exception);
+}
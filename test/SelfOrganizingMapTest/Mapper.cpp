@@ -0,0 +1,196 @@
+/**
+ * @file   SelfOrganizingMapTest/Mapper.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "SelfOrganizingMapLib/CartesianLayout.h"
+#include "SelfOrganizingMapLib/Data.h"
+#include "SelfOrganizingMapLib/DataView.h"
+#include "SelfOrganizingMapLib/find_best_match.h"
+#include "SelfOrganizingMapLib/Mapper.h"
+#include "SelfOrganizingMapLib/SOM.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+/// The batch mapping is identical to the mapping of the single data points
+TEST(MapperTest, map_batch)
+{
+    typedef Data<CartesianLayout<2>, float> DataType;
+    typedef DataView<CartesianLayout<2>, float> DataViewType;
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false> MapperType;
+
+    uint32_t som_dim = 3, image_dim = 12, neuron_dim = 9;
+
+    std::vector<DataType> images;
+    for (uint32_t i = 0; i < 13; ++i) {
+        std::vector<float> v(image_dim * image_dim);
+        fill_random_uniform(&v[0], v.size(), i);
+        images.push_back(DataType({image_dim, image_dim}, v));
+    }
+    std::vector<DataViewType> views(images.begin(), images.end());
+
+    std::vector<float> init(som_dim * som_dim * neuron_dim * neuron_dim);
+    fill_random_uniform(&init[0], init.size(), 42);
+    SOMType som({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+
+    for (uint32_t coarse_rotation_step : {1, 2}) {
+        for (auto&& backend : {EuclideanDistanceBackend::DIRECT, EuclideanDistanceBackend::GEMM}) {
+            MapperType mapper(som, 0, 16, true, Interpolation::BILINEAR, -1, backend, coarse_rotation_step);
+
+            auto&& results = mapper.map_batch(images);
+            auto&& view_results = mapper.map_batch(views);
+            ASSERT_EQ(images.size(), results.size());
+            ASSERT_EQ(images.size(), view_results.size());
+
+            for (size_t i = 0; i < images.size(); ++i) {
+                auto&& reference = mapper(images[i]);
+                EXPECT_EQ(std::get<0>(reference), std::get<0>(results[i]));
+                EXPECT_EQ(std::get<1>(reference), std::get<1>(results[i]));
+                EXPECT_EQ(std::get<0>(reference), std::get<0>(view_results[i]));
+                EXPECT_EQ(std::get<1>(reference), std::get<1>(view_results[i]));
+            }
+        }
+    }
+
+    MapperType mapper(som, 0, 16, true, Interpolation::BILINEAR);
+    EXPECT_TRUE(mapper.map_batch(std::vector<DataType>()).empty());
+}
+
+/// The mapping into reused result vectors is identical to the mapping into new ones
+TEST(MapperTest, reuse_results)
+{
+    typedef Data<CartesianLayout<2>, float> DataType;
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false> MapperType;
+
+    uint32_t som_dim = 3, image_dim = 12, neuron_dim = 9;
+
+    std::vector<float> init(som_dim * som_dim * neuron_dim * neuron_dim);
+    fill_random_uniform(&init[0], init.size(), 42);
+    SOMType som({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+
+    for (uint32_t coarse_rotation_step : {1, 2}) {
+        MapperType mapper(som, 0, 16, true, Interpolation::BILINEAR, -1, EuclideanDistanceBackend::DIRECT,
+            coarse_rotation_step);
+
+        std::vector<float> euclidean_distance_matrix;
+        std::vector<uint32_t> best_rotation_matrix;
+        for (uint32_t i = 0; i < 5; ++i) {
+            std::vector<float> v(image_dim * image_dim);
+            fill_random_uniform(&v[0], v.size(), i);
+            DataType image({image_dim, image_dim}, v);
+
+            auto&& reference = mapper(image);
+            mapper(image, euclidean_distance_matrix, best_rotation_matrix);
+            EXPECT_EQ(std::get<0>(reference), euclidean_distance_matrix);
+            EXPECT_EQ(std::get<1>(reference), best_rotation_matrix);
+        }
+    }
+}
+
+/// After update_som() the mapper uses the changed SOM
+TEST(MapperTest, update_som)
+{
+    typedef Data<CartesianLayout<2>, float> DataType;
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false> MapperType;
+
+    uint32_t som_dim = 3, image_dim = 12, neuron_dim = 9;
+
+    std::vector<float> v(image_dim * image_dim);
+    fill_random_uniform(&v[0], v.size(), 0);
+    DataType image({image_dim, image_dim}, v);
+
+    std::vector<float> init(som_dim * som_dim * neuron_dim * neuron_dim);
+    fill_random_uniform(&init[0], init.size(), 42);
+    SOMType som({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+
+    MapperType mapper(som, 0, 16, true, Interpolation::BILINEAR);
+    auto&& before = mapper(image);
+
+    fill_random_uniform(som.get_data_pointer(), init.size(), 43);
+    EXPECT_EQ(std::get<0>(before), std::get<0>(mapper(image)));
+
+    mapper.update_som();
+    auto&& after = mapper(image);
+    EXPECT_NE(std::get<0>(before), std::get<0>(after));
+    EXPECT_EQ(std::get<0>(MapperType(som, 0, 16, true, Interpolation::BILINEAR)(image)), std::get<0>(after));
+}
+
+/// Concurrent batch mappings from several OS threads do not share scratch arenas
+TEST(MapperTest, concurrent_map_batch)
+{
+    typedef Data<CartesianLayout<2>, float> DataType;
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false> MapperType;
+
+    uint32_t som_dim = 3, image_dim = 12, neuron_dim = 9;
+
+    std::vector<DataType> images;
+    for (uint32_t i = 0; i < 13; ++i) {
+        std::vector<float> v(image_dim * image_dim);
+        fill_random_uniform(&v[0], v.size(), i);
+        images.push_back(DataType({image_dim, image_dim}, v));
+    }
+
+    std::vector<float> init(som_dim * som_dim * neuron_dim * neuron_dim);
+    fill_random_uniform(&init[0], init.size(), 42);
+    SOMType som({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+
+    MapperType mapper(som, 0, 16, true, Interpolation::BILINEAR);
+    auto reference = mapper.map_batch(images);
+
+    std::vector<decltype(reference)> results(2);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); ++t) {
+        threads.emplace_back([&, t](){ results[t] = mapper.map_batch(images); });
+    }
+    for (auto&& thread : threads) thread.join();
+
+    for (auto&& result : results) {
+        ASSERT_EQ(reference.size(), result.size());
+        for (size_t i = 0; i < reference.size(); ++i) {
+            EXPECT_EQ(std::get<0>(reference[i]), std::get<0>(result[i]));
+            EXPECT_EQ(std::get<1>(reference[i]), std::get<1>(result[i]));
+        }
+    }
+}
+
+TEST(MapperTest, find_best_matches)
+{
+    std::vector<float> distances{3.0, 1.0, 4.0, 1.0, 5.0, 0.5};
+
+    EXPECT_EQ((std::vector<uint32_t>{5, 1, 3}), find_best_matches(distances, 6, 3));
+    EXPECT_EQ((std::vector<uint32_t>{find_best_match(distances, 6)}), find_best_matches(distances, 6, 1));
+    EXPECT_EQ((std::vector<uint32_t>{5, 1, 3, 0, 2, 4}), find_best_matches(distances, 6, 10));
+}
+
+TEST(MapperTest, get_best_matches)
+{
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false> MapperType;
+
+    SOMType som({2, 2}, {4, 4}, 0.0);
+    MapperType mapper(som, 0, 8, true, Interpolation::BILINEAR);
+
+    // Transformation 11 is flipped with the rotation 3
+    auto&& result = std::make_tuple(std::vector<float>{2.0, 0.0, 1.0, 3.0}, std::vector<uint32_t>{0, 11, 5, 1});
+    auto&& best_matches = mapper.get_best_matches(result, 2);
+
+    ASSERT_EQ(2UL, best_matches.size());
+    EXPECT_EQ(1U, best_matches[0].neuron);
+    EXPECT_EQ(0.0f, best_matches[0].euclidean_distance);
+    EXPECT_TRUE(best_matches[0].flip);
+    EXPECT_FLOAT_EQ(3 * 2.0 * M_PI / 8, best_matches[0].angle);
+    EXPECT_EQ(2U, best_matches[1].neuron);
+    EXPECT_EQ(1.0f, best_matches[1].euclidean_distance);
+    EXPECT_FALSE(best_matches[1].flip);
+    EXPECT_FLOAT_EQ(5 * 2.0 * M_PI / 8, best_matches[1].angle);
+}
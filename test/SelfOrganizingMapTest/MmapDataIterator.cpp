@@ -0,0 +1,194 @@
+/**
+ * @file   SelfOrganizingMapTest/MmapDataIterator.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "SelfOrganizingMapLib/CartesianLayout.h"
+#include "SelfOrganizingMapLib/Data.h"
+#include "SelfOrganizingMapLib/DataIterator.h"
+#include "SelfOrganizingMapLib/MmapDataIterator.h"
+#include "UtilitiesLib/pink_exception.h"
+
+using namespace pink;
+
+namespace {
+
+typedef Data<CartesianLayout<2>, float> DataType;
+
+/// Writes a data file of 2x3 images with the values i * 6 + j
+void write_data_file(std::string const& filename, std::string const& header, int number_of_entries)
+{
+    std::ofstream os(filename, std::ios::binary);
+    os << header;
+
+    std::vector<int> binary_header{2, 0, 0, number_of_entries, 0, 2, 2, 3};
+    os.write(reinterpret_cast<const char*>(&binary_header[0]), binary_header.size() * sizeof(int));
+    for (int i = 0; i < number_of_entries * 6; ++i) {
+        float value = i;
+        os.write(reinterpret_cast<const char*>(&value), sizeof(float));
+    }
+}
+
+} // namespace
+
+TEST(MmapDataIteratorTest, same_order_as_stream)
+{
+    std::string filename = "MmapDataIteratorTest_same_order_as_stream.bin";
+    write_data_file(filename, "# test file\n# END OF HEADER\n", 20);
+
+    EXPECT_TRUE((MmapDataIterator<CartesianLayout<2>, float>::is_applicable(filename)));
+
+    std::ifstream ifs(filename);
+    DataIterator<CartesianLayout<2>, float> iter(ifs, 5ul);
+    DataIterator<CartesianLayout<2>, float> end(ifs, true);
+
+    MmapDataIterator<CartesianLayout<2>, float> mmap_iter(filename, 5ul);
+    MmapDataIterator<CartesianLayout<2>, float> mmap_end(filename, true);
+
+    EXPECT_EQ(20, mmap_iter.get_number_of_entries());
+    EXPECT_EQ(2UL, mmap_iter->get_dimension()[0]);
+    EXPECT_EQ(3UL, mmap_iter->get_dimension()[1]);
+
+    // Two epochs to check set_to_begin
+    for (int epoch = 0; epoch < 2; ++epoch) {
+        int count = 0;
+        for (; mmap_iter != mmap_end; ++iter, ++mmap_iter, ++count) {
+            ASSERT_TRUE(iter != end);
+            EXPECT_EQ(*iter, DataType(*mmap_iter));
+            EXPECT_EQ(static_cast<int>((*mmap_iter)[0]) % 6, 0);
+        }
+        EXPECT_EQ(20, count);
+        EXPECT_TRUE(iter == end);
+
+        iter.set_to_begin();
+        mmap_iter.set_to_begin();
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(MmapDataIteratorTest, without_header)
+{
+    std::string filename = "MmapDataIteratorTest_without_header.bin";
+    write_data_file(filename, "", 1);
+
+    MmapDataIterator<CartesianLayout<2>, float> iter(filename);
+    EXPECT_EQ(DataType({2, 3}, std::vector<float>{0, 1, 2, 3, 4, 5}), DataType(*iter));
+    ++iter;
+    EXPECT_EQ((MmapDataIterator<CartesianLayout<2>, float>(filename, true)), iter);
+
+    std::remove(filename.c_str());
+}
+
+TEST(MmapDataIteratorTest, unaligned)
+{
+    std::string filename = "MmapDataIteratorTest_unaligned.bin";
+    write_data_file(filename, "# test\n# END OF HEADER\n", 1);
+
+    EXPECT_FALSE((MmapDataIterator<CartesianLayout<2>, float>::is_applicable(filename)));
+    EXPECT_THROW((MmapDataIterator<CartesianLayout<2>, float>(filename)), pink::exception);
+
+    std::remove(filename.c_str());
+}
+
+TEST(MmapDataIteratorTest, not_a_data_file)
+{
+    std::string filename = "MmapDataIteratorTest_not_a_data_file.bin";
+    {
+        // SOM file
+        std::ofstream os(filename, std::ios::binary);
+        std::vector<int> binary_header{2, 1, 0, 0, 2, 1, 1, 0, 2, 2, 3};
+        os.write(reinterpret_cast<const char*>(&binary_header[0]), binary_header.size() * sizeof(int));
+    }
+
+    try {
+        MmapDataIterator<CartesianLayout<2>, float> iterator(filename);
+        FAIL() << "Expected pink::exception";
+    } catch (pink::exception const& e) {
+        EXPECT_NE(std::string::npos, std::string(e.what()).find("is not a data file"));
+    }
+    EXPECT_THROW((MmapDataIterator<CartesianLayout<2>, float>::is_applicable(filename)), pink::exception);
+
+    std::remove(filename.c_str());
+}
+
+TEST(MmapDataIteratorTest, too_short)
+{
+    std::string filename = "MmapDataIteratorTest_too_short.bin";
+    write_data_file(filename, "", 2);
+    {
+        std::ofstream os(filename, std::ios::binary | std::ios::in);
+        os.seekp(3 * sizeof(int));
+        int number_of_entries = 3;
+        os.write(reinterpret_cast<const char*>(&number_of_entries), sizeof(int));
+    }
+
+    EXPECT_THROW((MmapDataIterator<CartesianLayout<2>, float>(filename)), pink::exception);
+
+    std::remove(filename.c_str());
+}
+
+TEST(MmapDataIteratorTest, block_shuffle)
+{
+    std::string filename = "MmapDataIteratorTest_block_shuffle.bin";
+    write_data_file(filename, "", 53);
+
+    std::ifstream ifs(filename);
+    DataIterator<CartesianLayout<2>, float> iter(ifs, 7ul, 4, 10);
+    DataIterator<CartesianLayout<2>, float> end(ifs, true);
+
+    MmapDataIterator<CartesianLayout<2>, float> mmap_iter(filename, 7ul, 4, 10);
+    MmapDataIterator<CartesianLayout<2>, float> mmap_end(filename, true);
+
+    for (int epoch = 0; epoch < 2; ++epoch) {
+        std::vector<int> entries;
+        for (; mmap_iter != mmap_end; ++iter, ++mmap_iter) {
+            ASSERT_TRUE(iter != end);
+            EXPECT_EQ(*iter, DataType(*mmap_iter));
+
+            // Entry i contains the values i * 6 + j
+            int entry = static_cast<int>((*iter)[0]) / 6;
+            std::vector<float> values(6);
+            for (int j = 0; j < 6; ++j) values[j] = entry * 6 + j;
+            EXPECT_EQ(DataType({2, 3}, values), *iter);
+            entries.push_back(entry);
+        }
+        EXPECT_TRUE(iter == end);
+
+        std::sort(entries.begin(), entries.end());
+        std::vector<int> reference(53);
+        std::iota(reference.begin(), reference.end(), 0);
+        EXPECT_EQ(reference, entries);
+
+        iter.set_to_begin();
+        mmap_iter.set_to_begin();
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(MmapDataIteratorTest, reduced_precision)
+{
+    std::string filename = "MmapDataIteratorTest_reduced_precision.bin";
+    {
+        std::ofstream os(filename, std::ios::binary);
+        std::vector<int> binary_header{2, 0, 6, 1, 0, 2, 2, 3};
+        os.write(reinterpret_cast<const char*>(&binary_header[0]), binary_header.size() * sizeof(int));
+        std::vector<uint8_t> values{0, 1, 2, 3, 4, 5};
+        os.write(reinterpret_cast<const char*>(&values[0]), values.size());
+    }
+
+    EXPECT_FALSE((MmapDataIterator<CartesianLayout<2>, float>::is_applicable(filename)));
+    EXPECT_THROW((MmapDataIterator<CartesianLayout<2>, float>(filename)), pink::exception);
+
+    std::remove(filename.c_str());
+}
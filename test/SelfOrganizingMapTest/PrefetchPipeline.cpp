@@ -0,0 +1,153 @@
+/**
+ * @file   SelfOrganizingMapTest/PrefetchPipeline.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "SelfOrganizingMapLib/CartesianLayout.h"
+#include "SelfOrganizingMapLib/Data.h"
+#include "SelfOrganizingMapLib/Mapper.h"
+#include "SelfOrganizingMapLib/PrefetchPipeline.h"
+#include "SelfOrganizingMapLib/SOM.h"
+#include "SelfOrganizingMapLib/Trainer.h"
+#include "UtilitiesLib/DistributionFunctor.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+namespace {
+
+typedef std::vector<int>::const_iterator IntIterator;
+typedef PrefetchPipeline<IntIterator, int> IntPipeline;
+
+} // namespace
+
+TEST(PrefetchPipelineTest, order)
+{
+    std::vector<int> values(100);
+    std::iota(values.begin(), values.end(), 0);
+
+    for (uint32_t queue_size : {1, 2, 16, 200}) {
+        auto&& iter = values.cbegin();
+        IntPipeline pipeline(iter, values.cend(), queue_size, [](int const& v){ return 2 * v; });
+
+        IntPipeline::Item item;
+        int count = 0;
+        for (; pipeline.pop(item); ++count) {
+            EXPECT_EQ(count, item.data);
+            EXPECT_EQ(2 * count, item.transformed);
+        }
+        EXPECT_EQ(100, count);
+        EXPECT_FALSE(pipeline.pop(item));
+    }
+}
+
+TEST(PrefetchPipelineTest, exception)
+{
+    std::vector<int> values(10);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto&& iter = values.cbegin();
+    IntPipeline pipeline(iter, values.cend(), 2, [](int const& v){
+        if (v == 5) throw std::runtime_error("transform");
+        return v;
+    });
+
+    IntPipeline::Item item;
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(pipeline.pop(item));
+    }
+    EXPECT_THROW(pipeline.pop(item), std::runtime_error);
+}
+
+/// The pipeline must be destroyable before all data are consumed
+TEST(PrefetchPipelineTest, cancel)
+{
+    std::vector<int> values(1000);
+    auto&& iter = values.cbegin();
+    {
+        IntPipeline pipeline(iter, values.cend(), 2, [](int const& v){ return v; });
+        IntPipeline::Item item;
+        EXPECT_TRUE(pipeline.pop(item));
+    }
+    EXPECT_TRUE(iter != values.cend());
+}
+
+/// The transformation of the next data points overlaps with the consumption
+TEST(PrefetchPipelineTest, overlap)
+{
+    std::vector<int> values(20);
+    auto&& delay = std::chrono::milliseconds(5);
+
+    auto&& start = std::chrono::steady_clock::now();
+    auto&& iter = values.cbegin();
+    IntPipeline pipeline(iter, values.cend(), 4, [&](int const& v){
+        std::this_thread::sleep_for(delay);
+        return v;
+    });
+    IntPipeline::Item item;
+    while (pipeline.pop(item)) std::this_thread::sleep_for(delay);
+    auto&& time = std::chrono::steady_clock::now() - start;
+
+    // Sequential processing would take 40 delays
+    EXPECT_LT(time, 30 * delay);
+}
+
+/// Training and mapping with prepared spatial transformations are identical to the sequential ones
+TEST(PrefetchPipelineTest, trainer_and_mapper)
+{
+    typedef Data<CartesianLayout<2>, float> DataType;
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Trainer<CartesianLayout<2>, CartesianLayout<2>, float, false> TrainerType;
+    typedef Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false> MapperType;
+    typedef PrefetchPipeline<std::vector<DataType>::const_iterator, std::vector<float>> PipelineType;
+
+    uint32_t som_dim = 3, image_dim = 10, number_of_rotations = 8;
+
+    std::vector<DataType> images;
+    for (uint32_t i = 0; i < 10; ++i) {
+        std::vector<float> v(image_dim * image_dim);
+        fill_random_uniform(&v[0], v.size(), i);
+        images.push_back(DataType({image_dim, image_dim}, v));
+    }
+    std::vector<float> init(som_dim * som_dim * image_dim * image_dim);
+    fill_random_uniform(&init[0], init.size(), 42);
+    auto&& f = GaussianFunctor(1.1, 0.2);
+
+    for (uint32_t coarse_rotation_step : {1, 2}) {
+        SOMType som1({som_dim, som_dim}, {image_dim, image_dim}, init);
+        TrainerType trainer1(som1, f, 0, number_of_rotations, true, -1.0, Interpolation::BILINEAR, -1,
+            EuclideanDistanceBackend::DIRECT, coarse_rotation_step);
+        for (auto&& image : images) trainer1(image);
+
+        SOMType som2({som_dim, som_dim}, {image_dim, image_dim}, init);
+        TrainerType trainer2(som2, f, 0, number_of_rotations, true, -1.0, Interpolation::BILINEAR, -1,
+            EuclideanDistanceBackend::DIRECT, coarse_rotation_step);
+        {
+            auto&& iter = images.cbegin();
+            PipelineType pipeline(iter, images.cend(), 3,
+                [&](DataType const& data){ return trainer2.transform(data); });
+            PipelineType::Item item;
+            while (pipeline.pop(item)) trainer2(item.data, item.transformed);
+        }
+        EXPECT_EQ(som1, som2);
+
+        MapperType mapper(som1, 0, number_of_rotations, true, Interpolation::BILINEAR, -1,
+            EuclideanDistanceBackend::DIRECT, coarse_rotation_step);
+        auto&& iter = images.cbegin();
+        PipelineType pipeline(iter, images.cend(), 3,
+            [&](DataType const& data){ return mapper.transform(data); });
+        PipelineType::Item item;
+        for (auto&& image : images) {
+            ASSERT_TRUE(pipeline.pop(item));
+            EXPECT_EQ(mapper(image), mapper(item.data, item.transformed));
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * @file   SelfOrganizingMapTest/ShuffleOrder.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+#include "SelfOrganizingMapLib/ShuffleOrder.h"
+
+using namespace pink;
+
+TEST(ShuffleOrderTest, full_shuffle)
+{
+    std::vector<uint32_t> buffer_ends;
+    auto&& order = get_block_shuffled_order(100, 0, 10, 1234, buffer_ends);
+
+    EXPECT_EQ(get_shuffled_order(100, 1234), order);
+    EXPECT_EQ(std::vector<uint32_t>{100}, buffer_ends);
+}
+
+TEST(ShuffleOrderTest, block_shuffle)
+{
+    uint32_t number_of_entries = 1003, block_size = 10, buffer_size = 95;
+
+    std::vector<uint32_t> buffer_ends;
+    auto&& order = get_block_shuffled_order(number_of_entries, block_size, buffer_size, 42, buffer_ends);
+
+    // Permutation of all entries
+    std::vector<uint32_t> sorted_order = order;
+    std::sort(sorted_order.begin(), sorted_order.end());
+    std::vector<uint32_t> reference(number_of_entries);
+    std::iota(reference.begin(), reference.end(), 0);
+    EXPECT_EQ(reference, sorted_order);
+
+    // Deterministic for the same seed
+    std::vector<uint32_t> buffer_ends2;
+    EXPECT_EQ(order, get_block_shuffled_order(number_of_entries, block_size, buffer_size, 42, buffer_ends2));
+    EXPECT_EQ(buffer_ends, buffer_ends2);
+    EXPECT_NE(order, get_block_shuffled_order(number_of_entries, block_size, buffer_size, 43, buffer_ends2));
+
+    // 101 blocks with 10 blocks per buffer
+    EXPECT_EQ(11UL, buffer_ends.size());
+    EXPECT_EQ(number_of_entries, buffer_ends.back());
+
+    // Each buffer consists of at most 10 contiguous ranges
+    uint32_t buffer_begin = 0;
+    for (auto&& buffer_end : buffer_ends) {
+        std::vector<uint32_t> entries(order.begin() + buffer_begin, order.begin() + buffer_end);
+        EXPECT_FALSE(std::is_sorted(entries.begin(), entries.end()));
+        std::sort(entries.begin(), entries.end());
+        auto&& ranges = get_contiguous_ranges(entries);
+        EXPECT_LE(ranges.size(), 10UL);
+        for (auto&& range : ranges) EXPECT_EQ(0U, range.first % block_size);
+        buffer_begin = buffer_end;
+    }
+}
+
+TEST(ShuffleOrderTest, contiguous_ranges)
+{
+    auto&& ranges = get_contiguous_ranges({1, 2, 3, 7, 9, 10});
+    std::vector<std::pair<uint32_t, uint32_t>> reference{{1, 3}, {7, 1}, {9, 2}};
+    EXPECT_EQ(reference, ranges);
+}
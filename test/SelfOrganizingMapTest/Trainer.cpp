@@ -4,6 +4,7 @@
  * @author Bernd Doser, HITS gGmbH
  */
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <omp.h>
@@ -15,6 +16,7 @@
 #include "SelfOrganizingMapLib/SOMIO.h"
 #include "SelfOrganizingMapLib/Trainer.h"
 #include "UtilitiesLib/DistributionFunctor.h"
+#include "UtilitiesLib/Filler.h"
 
 #include "gtest/gtest.h"
 
@@ -60,3 +62,163 @@ TEST(SelfOrganizingMapTest, trainer_cartesian_2d_int)
 
     EXPECT_EQ(155767632, (som.get_neuron({0, 0}) [{1, 1}] ));
 }
+
+/// The cached neuron windows are only refreshed for updated neurons. The result must be
+/// identical to a trainer created from scratch for each image, which packs all neurons.
+TEST(SelfOrganizingMapTest, trainer_neuron_window_cache)
+{
+    typedef Data<CartesianLayout<2>, float> DataType;
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Trainer<CartesianLayout<2>, CartesianLayout<2>, float, false> MyTrainer;
+
+    uint32_t som_dim = 4;
+    uint32_t image_dim = 12;
+    uint32_t neuron_dim = 8;
+    uint32_t number_of_images = 5;
+
+    std::vector<DataType> images;
+    for (uint32_t i = 0; i < number_of_images; ++i) {
+        std::vector<float> v(image_dim * image_dim);
+        fill_random_uniform(&v[0], v.size(), i);
+        images.push_back(DataType({image_dim, image_dim}, v));
+    }
+
+    std::vector<float> init(som_dim * som_dim * neuron_dim * neuron_dim);
+    fill_random_uniform(&init[0], init.size(), 42);
+
+    auto&& f = GaussianFunctor(1.1, 0.2);
+
+    for (auto&& backend : {EuclideanDistanceBackend::DIRECT, EuclideanDistanceBackend::GEMM})
+    {
+        SOMType som1({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+        SOMType som2({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+
+        MyTrainer trainer1(som1, f, 0, 8, true, 1.5, Interpolation::BILINEAR, -1, backend);
+        for (auto&& image : images) {
+            trainer1(image);
+            MyTrainer trainer2(som2, f, 0, 8, true, 1.5, Interpolation::BILINEAR, -1, backend);
+            trainer2(image);
+        }
+
+        EXPECT_EQ(som2, som1);
+    }
+}
+
+/// Only the neurons within max_update_distance of the best match are updated
+TEST(SelfOrganizingMapTest, trainer_max_update_distance)
+{
+    typedef Data<CartesianLayout<2>, float> DataType;
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Trainer<CartesianLayout<2>, CartesianLayout<2>, float, false> MyTrainer;
+
+    uint32_t som_dim = 5;
+    uint32_t neuron_dim = 4;
+    uint32_t neuron_size = neuron_dim * neuron_dim;
+
+    std::vector<float> init(som_dim * som_dim * neuron_size);
+    fill_random_uniform(&init[0], init.size(), 7);
+
+    // Image close to the center neuron, which will be the best match
+    std::vector<float> v(init.begin() + 12 * neuron_size, init.begin() + 13 * neuron_size);
+    for (auto&& e : v) e += 0.01;
+    DataType data({neuron_dim, neuron_dim}, v);
+
+    auto&& f = GaussianFunctor(1.1, 0.2);
+
+    for (auto&& pair : {std::make_pair(1.0f, 1u), std::make_pair(1.5f, 9u), std::make_pair(0.0f, 25u)})
+    {
+        SOMType som({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+        MyTrainer trainer(som, f, 0, 1, false, pair.first, Interpolation::BILINEAR);
+        trainer(data);
+
+        uint32_t number_of_updated_neurons = 0;
+        for (uint32_t i = 0; i < som_dim * som_dim; ++i) {
+            if (!std::equal(init.begin() + i * neuron_size, init.begin() + (i + 1) * neuron_size,
+                som.get_data_pointer() + i * neuron_size)) ++number_of_updated_neurons;
+        }
+
+        EXPECT_EQ(pair.second, number_of_updated_neurons);
+        EXPECT_EQ(1U, (trainer.get_update_info()[12]));
+    }
+}
+
+/// A batch with a single image corresponds to the online training
+TEST(SelfOrganizingMapTest, trainer_batch_single_image)
+{
+    typedef Data<CartesianLayout<2>, float> DataType;
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Trainer<CartesianLayout<2>, CartesianLayout<2>, float, false> MyTrainer;
+
+    uint32_t som_dim = 4;
+    uint32_t image_dim = 12;
+    uint32_t neuron_dim = 8;
+
+    std::vector<float> v(image_dim * image_dim);
+    fill_random_uniform(&v[0], v.size(), 3);
+    DataType data({image_dim, image_dim}, v);
+
+    std::vector<float> init(som_dim * som_dim * neuron_dim * neuron_dim);
+    fill_random_uniform(&init[0], init.size(), 42);
+
+    auto&& f = GaussianFunctor(1.1, 0.2);
+
+    SOMType som1({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+    MyTrainer trainer1(som1, f, 0, 8, true, -1.0, Interpolation::BILINEAR);
+    trainer1(data);
+
+    SOMType som2({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+    MyTrainer trainer2(som2, f, 0, 8, true, -1.0, Interpolation::BILINEAR);
+    trainer2(std::vector<DataType>{data});
+
+    for (uint32_t i = 0; i < init.size(); ++i) {
+        EXPECT_NEAR(som1.get_data_pointer()[i], som2.get_data_pointer()[i], 1e-6);
+    }
+    EXPECT_EQ(trainer1.get_update_info(), trainer2.get_update_info());
+}
+
+/// The result of the batch training must not depend on the number of threads
+TEST(SelfOrganizingMapTest, trainer_batch_threads)
+{
+    typedef Data<CartesianLayout<2>, float> DataType;
+    typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+    typedef Trainer<CartesianLayout<2>, CartesianLayout<2>, float, false> MyTrainer;
+
+    uint32_t som_dim = 4;
+    uint32_t image_dim = 12;
+    uint32_t neuron_dim = 8;
+    uint32_t batch_size = 13;
+
+    std::vector<DataType> batch;
+    for (uint32_t i = 0; i < batch_size; ++i) {
+        std::vector<float> v(image_dim * image_dim);
+        fill_random_uniform(&v[0], v.size(), i);
+        batch.push_back(DataType({image_dim, image_dim}, v));
+    }
+
+    std::vector<float> init(som_dim * som_dim * neuron_dim * neuron_dim);
+    fill_random_uniform(&init[0], init.size(), 42);
+
+    auto&& f = GaussianFunctor(1.1, 0.2);
+
+    SOMType som1({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+    MyTrainer trainer1(som1, f, 0, 8, true, 1.5, Interpolation::BILINEAR);
+    trainer1(batch);
+
+    uint32_t number_of_updates = 0;
+    for (auto&& e : trainer1.get_update_info().get_data()) number_of_updates += e;
+    EXPECT_EQ(batch_size, number_of_updates);
+
+    for (int number_of_threads = 2; number_of_threads <= 4; ++number_of_threads) {
+        omp_set_num_threads(number_of_threads);
+
+        SOMType som2({som_dim, som_dim}, {neuron_dim, neuron_dim}, init);
+        MyTrainer trainer2(som2, f, 0, 8, true, 1.5, Interpolation::BILINEAR);
+        trainer2(batch);
+
+        for (uint32_t i = 0; i < init.size(); ++i) {
+            EXPECT_NEAR(som1.get_data_pointer()[i], som2.get_data_pointer()[i], 1e-5);
+        }
+        EXPECT_EQ(trainer1.get_update_info(), trainer2.get_update_info());
+    }
+    omp_set_num_threads(1);
+}
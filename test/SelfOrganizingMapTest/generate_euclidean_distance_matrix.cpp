@@ -0,0 +1,110 @@
+/**
+ * @file   SelfOrganizingMapTest/generate_euclidean_distance_matrix.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <limits>
+#include <omp.h>
+#include <vector>
+
+#include "SelfOrganizingMapLib/generate_euclidean_distance_matrix.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+namespace {
+
+struct EuclideanDistanceMatrixTestData
+{
+    EuclideanDistanceMatrixTestData(uint32_t som_size, uint32_t image_dim, uint32_t num_rot, uint32_t euclidean_distance_dim)
+     : som_size(som_size),
+       image_dim(image_dim),
+       num_rot(num_rot),
+       euclidean_distance_dim(euclidean_distance_dim),
+       som(som_size * image_dim * image_dim),
+       rotated_images(num_rot * image_dim * image_dim)
+    {
+        fill_random_uniform(&som[0], som.size(), 1);
+        fill_random_uniform(&rotated_images[0], rotated_images.size(), 2);
+    }
+
+    uint32_t som_size;
+    uint32_t image_dim;
+    uint32_t num_rot;
+    uint32_t euclidean_distance_dim;
+
+    std::vector<float> som;
+    std::vector<float> rotated_images;
+};
+
+/// Sequential reference implementation
+void reference(std::vector<float>& euclidean_distance_matrix, std::vector<uint32_t>& best_rotation_matrix,
+    EuclideanDistanceMatrixTestData const& d)
+{
+    uint32_t image_size = d.image_dim * d.image_dim;
+    for (uint32_t i = 0; i < d.som_size; ++i) {
+        euclidean_distance_matrix[i] = std::numeric_limits<float>::max();
+        for (uint32_t j = 0; j < d.num_rot; ++j) {
+            float tmp = euclidean_distance_square_offset(&d.som[i * image_size], &d.rotated_images[j * image_size],
+                d.image_dim, d.euclidean_distance_dim);
+            if (tmp < euclidean_distance_matrix[i]) {
+                euclidean_distance_matrix[i] = tmp;
+                best_rotation_matrix[i] = j;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(EuclideanDistanceMatrixTest, compare_with_sequential)
+{
+    int max_threads = std::max(4, omp_get_num_procs());
+
+    for (auto&& d : {EuclideanDistanceMatrixTestData(1, 5, 1, 3),
+                     EuclideanDistanceMatrixTestData(3, 8, 7, 5),
+                     EuclideanDistanceMatrixTestData(25, 16, 16, 11)})
+    {
+        std::vector<float> est_distance(d.som_size);
+        std::vector<uint32_t> est_rotation(d.som_size);
+        reference(est_distance, est_rotation, d);
+
+        for (int number_of_threads = 1; number_of_threads <= max_threads; ++number_of_threads) {
+            omp_set_num_threads(number_of_threads);
+
+            std::vector<float> distance(d.som_size);
+            std::vector<uint32_t> rotation(d.som_size);
+            generate_euclidean_distance_matrix(distance, rotation, d.som_size, &d.som[0], d.image_dim,
+                d.num_rot, d.rotated_images, d.euclidean_distance_dim);
+
+            EXPECT_EQ(est_distance, distance);
+            EXPECT_EQ(est_rotation, rotation);
+        }
+    }
+    omp_set_num_threads(1);
+}
+
+TEST(EuclideanDistanceMatrixTest, gemm_backend)
+{
+    for (auto&& d : {EuclideanDistanceMatrixTestData(1, 5, 1, 3),
+                     EuclideanDistanceMatrixTestData(3, 8, 7, 5),
+                     EuclideanDistanceMatrixTestData(25, 16, 16, 11),
+                     EuclideanDistanceMatrixTestData(16, 45, 80, 31)})
+    {
+        std::vector<float> est_distance(d.som_size);
+        std::vector<uint32_t> est_rotation(d.som_size);
+        reference(est_distance, est_rotation, d);
+
+        std::vector<float> distance(d.som_size);
+        std::vector<uint32_t> rotation(d.som_size);
+        generate_euclidean_distance_matrix(distance, rotation, d.som_size, &d.som[0], d.image_dim,
+            d.num_rot, d.rotated_images, d.euclidean_distance_dim, EuclideanDistanceBackend::GEMM);
+
+        for (uint32_t i = 0; i < d.som_size; ++i) {
+            EXPECT_NEAR(est_distance[i], distance[i], 1e-4 * d.euclidean_distance_dim * d.euclidean_distance_dim);
+        }
+    }
+}
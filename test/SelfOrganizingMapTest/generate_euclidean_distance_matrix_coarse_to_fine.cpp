@@ -0,0 +1,191 @@
+/**
+ * @file   SelfOrganizingMapTest/generate_euclidean_distance_matrix_coarse_to_fine.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "SelfOrganizingMapLib/CartesianLayout.h"
+#include "SelfOrganizingMapLib/Data.h"
+#include "SelfOrganizingMapLib/generate_euclidean_distance_matrix_coarse_to_fine.h"
+#include "SelfOrganizingMapLib/generate_rotated_images.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+namespace {
+
+typedef Data<CartesianLayout<2>, float> DataType;
+
+/// Smooth image of a few gaussian blobs
+DataType generate_blob_image(uint32_t image_dim, uint32_t seed)
+{
+    std::vector<float> parameters(12);
+    fill_random_uniform(&parameters[0], parameters.size(), seed);
+
+    DataType image({image_dim, image_dim}, 0.0f);
+    for (uint32_t b = 0; b < 4; ++b) {
+        float x0 = (0.2 + 0.6 * parameters[3 * b]) * image_dim;
+        float y0 = (0.2 + 0.6 * parameters[3 * b + 1]) * image_dim;
+        float sigma = (0.05 + 0.1 * parameters[3 * b + 2]) * image_dim;
+        for (uint32_t x = 0; x < image_dim; ++x) {
+            for (uint32_t y = 0; y < image_dim; ++y) {
+                image[x * image_dim + y] += std::exp(-((x - x0) * (x - x0) + (y - y0) * (y - y0)) / (2 * sigma * sigma));
+            }
+        }
+    }
+    return image;
+}
+
+/// Exhaustive search using the same packed windows
+void exhaustive_search(std::vector<float>& euclidean_distance_matrix, std::vector<uint32_t>& best_rotation_matrix,
+    std::vector<float> const& packed_som, uint32_t som_size, DataType const& image, uint32_t neuron_dim,
+    uint32_t number_of_rotations, bool use_flip, uint32_t euclidean_distance_dim)
+{
+    auto&& spatial_transformed_images = generate_rotated_images(image, number_of_rotations, use_flip,
+        Interpolation::BILINEAR, neuron_dim);
+    uint32_t number_of_spatial_transformations = number_of_rotations * (use_flip ? 2 : 1);
+    uint32_t window_size = euclidean_distance_dim * euclidean_distance_dim;
+
+    std::vector<float> packed_images(number_of_spatial_transformations * window_size);
+    std::vector<float> norms(number_of_spatial_transformations);
+    pack_centered_windows(&packed_images[0], &norms[0], &spatial_transformed_images[0],
+        number_of_spatial_transformations, neuron_dim, euclidean_distance_dim);
+
+    generate_euclidean_distance_matrix_direct_packed(euclidean_distance_matrix, best_rotation_matrix, som_size,
+        &packed_som[0], number_of_spatial_transformations, &packed_images[0], window_size);
+}
+
+} // namespace
+
+TEST(CoarseToFineRotationTest, generate_rotated_image)
+{
+    for (uint32_t number_of_rotations : {1, 4, 8, 12, 360}) {
+        for (bool use_flip : {false, true}) {
+            for (uint32_t neuron_dim : {7, 10, 14}) {
+                uint32_t image_dim = 10;
+                auto&& image = generate_blob_image(image_dim, number_of_rotations);
+                auto&& all_images = generate_rotated_images(image, number_of_rotations, use_flip,
+                    Interpolation::BILINEAR, neuron_dim);
+
+                uint32_t neuron_size = neuron_dim * neuron_dim;
+                std::vector<float> rotated_image(neuron_size);
+                for (uint32_t t = 0; t < number_of_rotations * (use_flip ? 2 : 1); ++t) {
+                    generate_rotated_image(&rotated_image[0], image.get_data_pointer(), image_dim, neuron_dim,
+                        number_of_rotations, t, Interpolation::BILINEAR);
+                    EXPECT_EQ(std::vector<float>(all_images.begin() + t * neuron_size, all_images.begin() + (t + 1) * neuron_size),
+                        rotated_image) << "number_of_rotations = " << number_of_rotations << ", transformation = " << t;
+                }
+            }
+        }
+    }
+}
+
+TEST(CoarseToFineRotationTest, bilinear_rotation_plans)
+{
+    uint32_t image_dim = 10, neuron_dim = 7, number_of_rotations = 12;
+    uint32_t neuron_size = neuron_dim * neuron_dim;
+    auto&& image = generate_blob_image(image_dim, 3);
+
+    BilinearRotationPlanCache rotation_plans(neuron_dim, number_of_rotations, Interpolation::BILINEAR);
+    auto&& plans = rotation_plans.get(image_dim);
+    ASSERT_NE(nullptr, plans);
+    EXPECT_EQ(2UL, plans->size());
+    EXPECT_EQ(plans, rotation_plans.get(image_dim));
+    EXPECT_NE(plans, rotation_plans.get(image_dim + 2));
+
+    EXPECT_EQ(nullptr, BilinearRotationPlanCache(neuron_dim, number_of_rotations, Interpolation::NEAREST_NEIGHBOR).get(image_dim));
+    EXPECT_EQ(nullptr, BilinearRotationPlanCache(neuron_dim, 4, Interpolation::BILINEAR).get(image_dim));
+
+    auto&& all_images = generate_rotated_images(image, number_of_rotations, true, Interpolation::BILINEAR, neuron_dim);
+    EXPECT_EQ(all_images, generate_rotated_images(image, number_of_rotations, true, Interpolation::BILINEAR,
+        neuron_dim, plans));
+
+    std::vector<float> rotated_image(neuron_size);
+    for (uint32_t t = 0; t < 2 * number_of_rotations; ++t) {
+        generate_rotated_image(&rotated_image[0], image.get_data_pointer(), image_dim, neuron_dim,
+            number_of_rotations, t, Interpolation::BILINEAR, plans);
+        EXPECT_EQ(std::vector<float>(all_images.begin() + t * neuron_size, all_images.begin() + (t + 1) * neuron_size),
+            rotated_image) << "transformation = " << t;
+    }
+}
+
+TEST(CoarseToFineRotationTest, step_one_is_exhaustive)
+{
+    uint32_t som_size = 9, image_dim = 20, neuron_dim = 20, euclidean_distance_dim = 14, number_of_rotations = 16;
+    uint32_t window_size = euclidean_distance_dim * euclidean_distance_dim;
+
+    std::vector<float> som(som_size * neuron_dim * neuron_dim);
+    fill_random_uniform(&som[0], som.size(), 1);
+    std::vector<float> packed_som(som_size * window_size), norms(som_size);
+    pack_centered_windows(&packed_som[0], &norms[0], &som[0], som_size, neuron_dim, euclidean_distance_dim);
+
+    auto&& image = generate_blob_image(image_dim, 2);
+
+    std::vector<float> est_distance(som_size);
+    std::vector<uint32_t> est_rotation(som_size);
+    exhaustive_search(est_distance, est_rotation, packed_som, som_size, image, neuron_dim,
+        number_of_rotations, true, euclidean_distance_dim);
+
+    std::vector<float> distance(som_size);
+    std::vector<uint32_t> rotation(som_size);
+    std::vector<float> spatial_transformed_images;
+    generate_euclidean_distance_matrix_coarse_to_fine(distance, rotation, som_size, &packed_som[0],
+        image.get_data_pointer(), image_dim, neuron_dim, number_of_rotations, true, Interpolation::BILINEAR,
+        euclidean_distance_dim, 1, 2, spatial_transformed_images);
+
+    EXPECT_EQ(est_distance, distance);
+    EXPECT_EQ(est_rotation, rotation);
+}
+
+/// Neurons are rotated copies of smooth images, the coarse-to-fine search must find the exhaustive result
+TEST(CoarseToFineRotationTest, smooth_images)
+{
+    uint32_t som_size = 16, image_dim = 32, neuron_dim = 32, euclidean_distance_dim = 22, number_of_rotations = 360;
+    uint32_t neuron_size = neuron_dim * neuron_dim;
+    uint32_t window_size = euclidean_distance_dim * euclidean_distance_dim;
+    auto&& image = generate_blob_image(image_dim, 3);
+
+    // Neurons are spatial transformations of the image with additional blobs
+    std::vector<float> som(som_size * neuron_size);
+    for (uint32_t i = 0; i < som_size; ++i) {
+        auto&& other = generate_blob_image(image_dim, 100 + i);
+        DataType neuron = image;
+        for (uint32_t j = 0; j < neuron_size; ++j) neuron[j] += 0.2 * other[j];
+        generate_rotated_image(&som[i * neuron_size], neuron.get_data_pointer(), image_dim, neuron_dim,
+            number_of_rotations, (i * 97) % (2 * number_of_rotations), Interpolation::BILINEAR);
+    }
+
+    std::vector<float> packed_som(som_size * window_size), norms(som_size);
+    pack_centered_windows(&packed_som[0], &norms[0], &som[0], som_size, neuron_dim, euclidean_distance_dim);
+
+    std::vector<float> est_distance(som_size);
+    std::vector<uint32_t> est_rotation(som_size);
+    exhaustive_search(est_distance, est_rotation, packed_som, som_size, image, neuron_dim,
+        number_of_rotations, true, euclidean_distance_dim);
+
+    for (uint32_t step : {4, 8, 16}) {
+        std::vector<float> distance(som_size);
+        std::vector<uint32_t> rotation(som_size);
+        std::vector<float> spatial_transformed_images;
+        generate_euclidean_distance_matrix_coarse_to_fine(distance, rotation, som_size, &packed_som[0],
+            image.get_data_pointer(), image_dim, neuron_dim, number_of_rotations, true, Interpolation::BILINEAR,
+            euclidean_distance_dim, step, 2, spatial_transformed_images);
+
+        for (uint32_t i = 0; i < som_size; ++i) {
+            EXPECT_EQ(est_distance[i], distance[i]) << "step = " << step << ", neuron = " << i;
+            EXPECT_EQ(est_rotation[i], rotation[i]) << "step = " << step << ", neuron = " << i;
+
+            // The spatial transformation of the best match must be available
+            std::vector<float> rotated_image(neuron_size);
+            generate_rotated_image(&rotated_image[0], image.get_data_pointer(), image_dim, neuron_dim,
+                number_of_rotations, rotation[i], Interpolation::BILINEAR);
+            EXPECT_TRUE(std::equal(rotated_image.begin(), rotated_image.end(),
+                spatial_transformed_images.begin() + rotation[i] * neuron_size));
+        }
+    }
+}
@@ -0,0 +1,129 @@
+/**
+ * @file   SelfOrganizingMapTest/train_hogwild.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <omp.h>
+#include <random>
+#include <vector>
+
+#include "SelfOrganizingMapLib/CartesianLayout.h"
+#include "SelfOrganizingMapLib/Data.h"
+#include "SelfOrganizingMapLib/Mapper.h"
+#include "SelfOrganizingMapLib/SOM.h"
+#include "SelfOrganizingMapLib/Trainer.h"
+#include "UtilitiesLib/DistributionFunctor.h"
+#include "UtilitiesLib/Filler.h"
+
+using namespace pink;
+
+namespace {
+
+typedef Data<CartesianLayout<2>, float> DataType;
+typedef SOM<CartesianLayout<2>, CartesianLayout<2>, float> SOMType;
+typedef Trainer<CartesianLayout<2>, CartesianLayout<2>, float, false> TrainerType;
+typedef Mapper<CartesianLayout<2>, CartesianLayout<2>, float, false> MapperType;
+
+uint32_t som_dim = 4;
+uint32_t image_dim = 16;
+uint32_t number_of_rotations = 4;
+
+/// Noisy copies of a few random prototypes
+std::vector<DataType> generate_clustered_images(uint32_t number_of_images, uint32_t number_of_prototypes)
+{
+    uint32_t image_size = image_dim * image_dim;
+    std::vector<float> prototypes(number_of_prototypes * image_size);
+    fill_random_uniform(&prototypes[0], prototypes.size(), 1);
+
+    std::mt19937 rng(2);
+    std::normal_distribution<float> noise(0.0, 0.1);
+
+    std::vector<DataType> images;
+    for (uint32_t i = 0; i < number_of_images; ++i) {
+        std::vector<float> v(prototypes.begin() + (i % number_of_prototypes) * image_size,
+                             prototypes.begin() + (i % number_of_prototypes + 1) * image_size);
+        for (auto&& e : v) e += noise(rng);
+        images.push_back(DataType({image_dim, image_dim}, v));
+    }
+    return images;
+}
+
+/// Mean of the minimal euclidean distance of all images to the SOM
+float quantization_error(SOMType& som, std::vector<DataType> const& images)
+{
+    MapperType mapper(som, 0, number_of_rotations, false, Interpolation::BILINEAR);
+    float sum = 0.0;
+    for (auto&& image : images) {
+        auto&& result = mapper(image);
+        sum += std::sqrt(*std::min_element(std::get<0>(result).begin(), std::get<0>(result).end()));
+    }
+    return sum / images.size();
+}
+
+} // namespace
+
+/// With a single thread the Hogwild training is identical to the sequential training
+TEST(SelfOrganizingMapTest, train_hogwild_single_thread)
+{
+    auto&& images = generate_clustered_images(40, 4);
+    std::vector<float> init(som_dim * som_dim * image_dim * image_dim);
+    fill_random_uniform(&init[0], init.size(), 3);
+    auto&& f = GaussianFunctor(1.1, 0.2);
+
+    SOMType som1({som_dim, som_dim}, {image_dim, image_dim}, init);
+    TrainerType trainer1(som1, f, 0, number_of_rotations, false, -1.0, Interpolation::BILINEAR);
+    for (auto&& image : images) trainer1(image);
+
+    omp_set_num_threads(1);
+    SOMType som2({som_dim, som_dim}, {image_dim, image_dim}, init);
+    TrainerType trainer2(som2, f, 0, number_of_rotations, false, -1.0, Interpolation::BILINEAR);
+    auto&& iter = images.cbegin();
+    uint32_t number_of_steps = 0;
+    trainer2.train_hogwild(iter, images.cend(), [&](){ ++number_of_steps; });
+
+    EXPECT_EQ(som1, som2);
+    EXPECT_EQ(trainer1.get_update_info(), trainer2.get_update_info());
+    EXPECT_EQ(images.size(), number_of_steps);
+}
+
+/// The cached neuron windows and norms of the GEMM backend are not consistent under concurrent updates
+TEST(SelfOrganizingMapTest, train_hogwild_gemm)
+{
+    auto&& images = generate_clustered_images(4, 4);
+    SOMType som({som_dim, som_dim}, {image_dim, image_dim}, 0.0);
+    TrainerType trainer(som, GaussianFunctor(1.1, 0.2), 0, number_of_rotations, false, -1.0, Interpolation::BILINEAR,
+        -1, EuclideanDistanceBackend::GEMM);
+
+    auto&& iter = images.cbegin();
+    EXPECT_THROW(trainer.train_hogwild(iter, images.cend()), pink::exception);
+}
+
+/// The Hogwild training with a fixed number of threads reduces the quantization error of the initial SOM.
+/// The order of the updates depends on the thread scheduling, therefore the error is not compared
+/// to the sequential training.
+TEST(SelfOrganizingMapTest, train_hogwild_convergence)
+{
+    auto&& images = generate_clustered_images(400, 8);
+    std::vector<float> init(som_dim * som_dim * image_dim * image_dim);
+    fill_random_uniform(&init[0], init.size(), 3);
+    auto&& f = GaussianFunctor(1.1, 0.2);
+    int number_of_epochs = 3;
+
+    SOMType som_init({som_dim, som_dim}, {image_dim, image_dim}, init);
+    float initial_error = quantization_error(som_init, images);
+
+    omp_set_num_threads(4);
+    SOMType som({som_dim, som_dim}, {image_dim, image_dim}, init);
+    TrainerType trainer(som, f, 0, number_of_rotations, false, -1.0, Interpolation::BILINEAR);
+
+    for (int epoch = 0; epoch < number_of_epochs; ++epoch) {
+        auto&& iter = images.cbegin();
+        trainer.train_hogwild(iter, images.cend());
+    }
+    omp_set_num_threads(1);
+
+    EXPECT_LT(quantization_error(som, images), initial_error);
+}
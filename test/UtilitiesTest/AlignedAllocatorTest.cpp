@@ -0,0 +1,54 @@
+/**
+ * @file   UtilitiesTest/AlignedAllocatorTest.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "UtilitiesLib/AlignedAllocator.h"
+
+using namespace pink;
+
+TEST(AlignedAllocatorTest, alignment)
+{
+    for (size_t size : {1, 3, 17, 1000, 100000})
+    {
+        AlignedVector<float> v(size);
+        EXPECT_EQ(0UL, reinterpret_cast<uintptr_t>(v.data()) % cache_line_size);
+    }
+
+    AlignedVector<float> v(1 << 20);
+    EXPECT_EQ(0UL, reinterpret_cast<uintptr_t>(v.data()) % sysconf(_SC_PAGESIZE));
+}
+
+TEST(AlignedAllocatorTest, huge_pages)
+{
+    set_use_huge_pages(true);
+    AlignedVector<float> v(huge_page_size / sizeof(float));
+    set_use_huge_pages(false);
+
+    EXPECT_EQ(0UL, reinterpret_cast<uintptr_t>(v.data()) % huge_page_size);
+}
+
+TEST(AlignedAllocatorTest, padded_size)
+{
+    EXPECT_EQ(0UL, get_padded_size<float>(0));
+    EXPECT_EQ(16UL, get_padded_size<float>(1));
+    EXPECT_EQ(16UL, get_padded_size<float>(16));
+    EXPECT_EQ(32UL, get_padded_size<float>(17));
+    EXPECT_EQ(8UL, get_padded_size<double>(5));
+}
+
+TEST(AlignedAllocatorTest, first_touch)
+{
+    AlignedVector<float> v(100);
+    first_touch(v.data(), v.size(), 2.0f);
+    for (auto&& e : v) EXPECT_EQ(2.0f, e);
+
+    std::vector<float> values(100);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = i;
+    first_touch(v.data(), values.data(), values.size());
+    EXPECT_EQ(values, std::vector<float>(v.begin(), v.end()));
+}
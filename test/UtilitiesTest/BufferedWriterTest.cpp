@@ -0,0 +1,76 @@
+/**
+ * @file   UtilitiesTest/BufferedWriterTest.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "UtilitiesLib/BufferedWriter.h"
+
+using namespace pink;
+
+namespace {
+
+std::vector<char> read_file(std::string const& filename)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+TEST(BufferedWriterTest, content)
+{
+    std::string filename = "BufferedWriterTest_content.bin";
+
+    for (bool background_flush : {false, true}) {
+        for (bool direct_io : {false, true}) {
+            std::vector<char> reference;
+            {
+                BufferedWriter writer(filename, 1, background_flush, direct_io);
+                for (int i = 0; i < 3000; ++i) {
+                    char flip = i % 2;
+                    float angle = 0.1f * i;
+                    writer.write(flip);
+                    writer.write(angle);
+                    reference.push_back(flip);
+                    reference.insert(reference.end(), reinterpret_cast<char*>(&angle),
+                        reinterpret_cast<char*>(&angle) + sizeof(float));
+                }
+
+                // Larger than the buffer
+                std::vector<char> large(10000, 'x');
+                writer.write(&large[0], large.size());
+                reference.insert(reference.end(), large.begin(), large.end());
+            }
+            EXPECT_EQ(reference, read_file(filename));
+        }
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(BufferedWriterTest, close)
+{
+    std::string filename = "BufferedWriterTest_close.bin";
+
+    BufferedWriter writer(filename, 4096, true);
+    int value = 42;
+    writer.write(value);
+    writer.close();
+    writer.close();
+    EXPECT_EQ(sizeof(int), read_file(filename).size());
+
+    std::remove(filename.c_str());
+}
+
+TEST(BufferedWriterTest, open_error)
+{
+    EXPECT_THROW(BufferedWriter("not_existing_directory/file.bin"), pink::exception);
+}
@@ -0,0 +1,51 @@
+/**
+ * @file   UtilitiesTest/FileDataTypeTest.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+#include "UtilitiesLib/FileDataType.h"
+
+using namespace pink;
+
+TEST(FileDataTypeTest, float16_to_float)
+{
+    EXPECT_EQ(0.0f, float16_to_float(0x0000));
+    EXPECT_TRUE(std::signbit(float16_to_float(0x8000)));
+    EXPECT_EQ(1.0f, float16_to_float(0x3c00));
+    EXPECT_EQ(-2.0f, float16_to_float(0xc000));
+    EXPECT_EQ(65504.0f, float16_to_float(0x7bff));
+    EXPECT_EQ(std::ldexp(1.0f, -14), float16_to_float(0x0400));
+    EXPECT_EQ(std::ldexp(1.0f, -24), float16_to_float(0x0001));
+    EXPECT_EQ(std::ldexp(1023.0f, -24), float16_to_float(0x03ff));
+    EXPECT_EQ(std::numeric_limits<float>::infinity(), float16_to_float(0x7c00));
+    EXPECT_EQ(-std::numeric_limits<float>::infinity(), float16_to_float(0xfc00));
+    EXPECT_TRUE(std::isnan(float16_to_float(0x7e00)));
+}
+
+TEST(FileDataTypeTest, convert)
+{
+    std::vector<uint16_t> src{0, 1, 255, 65535};
+    std::vector<float> dst(4);
+    convert(reinterpret_cast<char const*>(&src[0]), FileDataType::UINT16, &dst[0], 4);
+    EXPECT_EQ((std::vector<float>{0, 1, 255, 65535}), dst);
+
+    std::vector<double> dst_double(4);
+    convert(reinterpret_cast<char const*>(&src[0]), FileDataType::FLOAT16, &dst_double[0], 2);
+    EXPECT_EQ(0.0, dst_double[0]);
+    EXPECT_EQ(std::ldexp(1.0, -24), dst_double[1]);
+}
+
+TEST(FileDataTypeTest, get_file_data_type)
+{
+    EXPECT_EQ(FileDataType::UINT8, get_file_data_type(6));
+    EXPECT_EQ(2UL, get_size(get_file_data_type(10)));
+    EXPECT_THROW(get_file_data_type(1), pink::exception);
+    EXPECT_TRUE(is_native<float>(FileDataType::FLOAT32));
+    EXPECT_FALSE(is_native<double>(FileDataType::FLOAT32));
+}
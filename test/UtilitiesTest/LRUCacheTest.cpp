@@ -0,0 +1,35 @@
+/**
+ * @file   UtilitiesTest/LRUCacheTest.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "UtilitiesLib/LRUCache.h"
+
+using namespace pink;
+
+TEST(LRUCacheTest, replace_least_recently_used)
+{
+    LRUCache<int, std::string> cache(2);
+    EXPECT_EQ(nullptr, cache.find(1));
+
+    EXPECT_EQ("one", cache.insert(1, "one"));
+    cache.insert(2, "two");
+    EXPECT_EQ(2UL, cache.size());
+
+    // 1 is used more recently than 2
+    ASSERT_NE(nullptr, cache.find(1));
+    EXPECT_EQ("one", *cache.find(1));
+
+    cache.insert(3, "three");
+    EXPECT_EQ(2UL, cache.size());
+    EXPECT_EQ(nullptr, cache.find(2));
+    EXPECT_EQ("one", *cache.find(1));
+    EXPECT_EQ("three", *cache.find(3));
+
+    cache.clear();
+    EXPECT_EQ(nullptr, cache.find(1));
+}
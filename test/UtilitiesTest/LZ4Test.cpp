@@ -0,0 +1,90 @@
+/**
+ * @file   UtilitiesTest/LZ4Test.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "UtilitiesLib/LZ4.h"
+
+using namespace pink;
+
+namespace {
+
+void check_round_trip(std::vector<char> const& data)
+{
+    auto&& compressed = lz4_compress(data.data(), data.size());
+    EXPECT_LE(compressed.size(), lz4_compress_bound(data.size()));
+
+    std::vector<char> decompressed(data.size());
+    lz4_decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size());
+    EXPECT_EQ(data, decompressed);
+}
+
+} // namespace
+
+TEST(LZ4Test, round_trip)
+{
+    std::mt19937 engine(42);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    for (size_t size : {0, 1, 12, 13, 100, 1000, 100000}) {
+        // Random data are incompressible
+        std::vector<char> random(size);
+        for (auto&& c : random) c = static_cast<char>(byte(engine));
+        check_round_trip(random);
+
+        // Sparse data with long runs of zeros
+        std::vector<char> sparse(size, 0);
+        for (size_t i = 0; i < size; i += 97) sparse[i] = static_cast<char>(byte(engine));
+        check_round_trip(sparse);
+
+        // Repeated patterns with overlapping matches
+        std::vector<char> pattern(size);
+        for (size_t i = 0; i < size; ++i) pattern[i] = "abc"[i % 3];
+        check_round_trip(pattern);
+    }
+}
+
+TEST(LZ4Test, compression_ratio)
+{
+    std::vector<float> sparse(10000, 0.0f);
+    for (size_t i = 0; i < sparse.size(); i += 100) sparse[i] = 1.0f;
+
+    auto&& compressed = lz4_compress(reinterpret_cast<char const*>(sparse.data()), sparse.size() * sizeof(float));
+    EXPECT_LT(compressed.size() * 20, sparse.size() * sizeof(float));
+}
+
+TEST(LZ4Test, reference_block)
+{
+    // "abcabcabcabcabcabcabc" compressed by the reference implementation
+    std::vector<char> block{0x39, 'a', 'b', 'c', 0x03, 0x00, 0x50, 'b', 'c', 'a', 'b', 'c'};
+    std::string reference = "abcabcabcabcabcabcabc";
+
+    std::vector<char> decompressed(reference.size());
+    lz4_decompress(block.data(), block.size(), decompressed.data(), decompressed.size());
+    EXPECT_EQ(reference, std::string(decompressed.begin(), decompressed.end()));
+}
+
+TEST(LZ4Test, corrupted)
+{
+    std::vector<char> data(1000, 'x');
+    auto&& compressed = lz4_compress(data.data(), data.size());
+    std::vector<char> decompressed(data.size());
+
+    // Wrong size of the decompressed data
+    EXPECT_THROW(lz4_decompress(compressed.data(), compressed.size(), decompressed.data(), 999), pink::exception);
+
+    // Truncated block
+    EXPECT_THROW(lz4_decompress(compressed.data(), compressed.size() - 3, decompressed.data(), decompressed.size()),
+        pink::exception);
+
+    // Offset before the beginning of the block
+    std::vector<char> invalid{0x10, 'a', 0x05, 0x00, 0x10, 'a'};
+    EXPECT_THROW(lz4_decompress(invalid.data(), invalid.size(), decompressed.data(), decompressed.size()),
+        pink::exception);
+}
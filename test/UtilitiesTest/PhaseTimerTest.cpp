@@ -0,0 +1,73 @@
+/**
+ * @file   UtilitiesTest/PhaseTimerTest.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <future>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "UtilitiesLib/PhaseTimer.h"
+
+using namespace pink;
+
+namespace {
+
+/// Returns the number of calls of the phase summed over all threads
+uint64_t get_calls(Phase phase)
+{
+    std::stringstream ss;
+    PhaseTimerRegistry::instance().write_json(ss, "test", 0);
+    std::string json = ss.str();
+
+    // The total is the first object of the phase
+    std::string key = std::string("\"") + get_phase_name(phase) + "\": {\"seconds\": ";
+    auto&& pos = json.find("\"calls\": ", json.find(key));
+    return std::stoull(json.substr(pos + 9));
+}
+
+} // namespace
+
+TEST(PhaseTimerTest, disabled)
+{
+    auto&& registry = PhaseTimerRegistry::instance();
+    registry.enable(false);
+    registry.reset();
+
+    { ScopedPhaseTimer timer(Phase::IO); }
+    EXPECT_EQ(0UL, get_calls(Phase::IO));
+}
+
+TEST(PhaseTimerTest, nested_and_threads)
+{
+    auto&& registry = PhaseTimerRegistry::instance();
+    registry.enable();
+    registry.reset();
+
+    {
+        ScopedPhaseTimer timer(Phase::ROTATION);
+        // Only the outermost timer of a thread is counted
+        ScopedPhaseTimer nested(Phase::DISTANCE);
+    }
+    { ScopedPhaseTimer timer(Phase::DISTANCE); }
+
+    // The times of a finished thread are kept
+    std::async(std::launch::async, [](){ ScopedPhaseTimer timer(Phase::DISTANCE); }).get();
+
+    EXPECT_EQ(1UL, get_calls(Phase::ROTATION));
+    EXPECT_EQ(2UL, get_calls(Phase::DISTANCE));
+    EXPECT_EQ(0UL, get_calls(Phase::UPDATE));
+
+    std::stringstream ss;
+    registry.write_json(ss, "final", 42);
+    std::string json = ss.str();
+    EXPECT_EQ(0UL, json.find("{\"event\": \"final\""));
+    EXPECT_NE(std::string::npos, json.find("\"processed_entries\": 42"));
+    EXPECT_NE(std::string::npos, json.find("\"threads\": [{\"thread\": "));
+    EXPECT_EQ('\n', json.back());
+
+    registry.enable(false);
+    registry.reset();
+}
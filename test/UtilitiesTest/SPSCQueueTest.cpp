@@ -0,0 +1,54 @@
+/**
+ * @file   UtilitiesTest/SPSCQueueTest.cpp
+ * @date   Oct 17, 2026
+ * @author Bernd Doser, HITS gGmbH
+ */
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "UtilitiesLib/SPSCQueue.h"
+
+using namespace pink;
+
+/// A slow producer lets the consumer sleep, the order of the values is preserved
+TEST(SPSCQueueTest, slow_producer)
+{
+    SPSCQueue<int> queue(2);
+    auto&& never = [](){ return false; };
+
+    std::thread producer([&]() {
+        for (int i = 0; i < 5; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            queue.push(i, never);
+        }
+        queue.close();
+    });
+
+    int value;
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(queue.pop(value, never));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(queue.pop(value, never));
+    producer.join();
+}
+
+/// A sleeping consumer is woken up by the notification after cancelling
+TEST(SPSCQueueTest, cancel)
+{
+    SPSCQueue<int> queue(2);
+    std::atomic<bool> cancelled(false);
+
+    std::thread consumer([&]() {
+        int value;
+        EXPECT_FALSE(queue.pop(value, [&](){ return cancelled.load(); }));
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    cancelled = true;
+    queue.notify();
+    consumer.join();
+}